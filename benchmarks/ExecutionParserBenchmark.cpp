@@ -0,0 +1,682 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+/*
+Benchmarks ExecutionParser on synthetic graphs and prints one record per measurement so runs can be diffed between releases.
+
+    PrincessBenchmarks [--shapes=wide,deep,balanced] [--nodes=1k,100k] [--roots=64] [--edits=1000]
+                       [--codegen-nodes=1M] [--chain-depth=1M] [--repetitions=3] [--seed=1337] [--format=json|csv]
+
+Node counts take k/M suffixes. Every measurement keeps its fastest repetition, json output is one object per line.
+--codegen-nodes builds one more graph per shape that big and times emitting every root by walking the nodes (codegen_dfs, what
+ExecutionParser::DFS does) against emitting from the flattened snapshots (codegen_flattened, built beforehand in flatten), 0 skips it.
+--chain-depth runs a single root with one unbroken chain of nested blocks that deep after the shapes, 0 skips it.
+*/
+#include "SyntheticBlockNodeGraph.h"
+#include "Parsers/LuaScriptBackend.h"
+#include "BlockNodeTraversal.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Princess;
+
+//////////////////////////////////////////////
+// Benchmark Results
+//////////////////////////////////////////////
+
+struct BenchmarkResult
+{
+    std::string m_Name;
+    SyntheticGraphShape m_Shape;
+    size_t m_NodeCount = 0;
+    size_t m_Items = 0; //whatever the benchmark processes, nodes for codegen, operations for edits
+    size_t m_Bytes = 0; //script bytes produced, 0 when it doesn't apply
+    double m_Seconds = 0.0;
+};
+
+struct BenchmarkOptions
+{
+    std::vector<SyntheticGraphShape> m_Shapes = { SyntheticGraphShape::Wide, SyntheticGraphShape::Deep, SyntheticGraphShape::Balanced };
+    std::vector<size_t> m_NodeCounts = { 1'000, 100'000 };
+
+    size_t m_RootCount = 64;
+    size_t m_EditCount = 1'000;
+    size_t m_CodegenNodeCount = 1'000'000;
+    size_t m_ChainDepth = 1'000'000;
+    size_t m_Repetitions = 3;
+    uint64_t m_Seed = 1337;
+
+    bool m_IsCSV = false;
+};
+
+static volatile size_t g_DoNotOptimize = 0; //lookups feed into this so the compiler can't drop them
+
+//////////////////////////////////////////////
+// Helpers
+//////////////////////////////////////////////
+
+template<typename Function>
+static double
+    TimeSeconds(Function&& fp_Function)
+{
+    const auto f_Start = std::chrono::steady_clock::now();
+    fp_Function();
+    const auto f_End = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double>(f_End - f_Start).count();
+}
+
+static size_t
+    ParseCount(std::string_view fp_Text) //"10M" -> 10'000'000
+{
+    size_t f_Multiplier = 1;
+
+    if (not fp_Text.empty() and (fp_Text.back() == 'k' or fp_Text.back() == 'K'))
+    {
+        f_Multiplier = 1'000;
+        fp_Text.remove_suffix(1);
+    }
+    else if (not fp_Text.empty() and (fp_Text.back() == 'm' or fp_Text.back() == 'M'))
+    {
+        f_Multiplier = 1'000'000;
+        fp_Text.remove_suffix(1);
+    }
+
+    return std::strtoull(std::string(fp_Text).c_str(), nullptr, 10) * f_Multiplier;
+}
+
+static std::vector<std::string_view>
+    SplitList(std::string_view fp_Text)
+{
+    std::vector<std::string_view> f_Items;
+
+    while (not fp_Text.empty())
+    {
+        const size_t f_Comma = fp_Text.find(',');
+        f_Items.push_back(fp_Text.substr(0, f_Comma));
+
+        if (f_Comma == std::string_view::npos)
+        {
+            break;
+        }
+
+        fp_Text.remove_prefix(f_Comma + 1);
+    }
+
+    return f_Items;
+}
+
+static bool
+    ParseOptions(const int fp_ArgCount, const char* fp_ArgVector[], BenchmarkOptions& fp_Options)
+{
+    for (int l_Arg = 1; l_Arg < fp_ArgCount; l_Arg++)
+    {
+        const std::string_view f_Arg = fp_ArgVector[l_Arg];
+        const size_t f_Equals = f_Arg.find('=');
+        const std::string_view f_Key = f_Arg.substr(0, f_Equals);
+        const std::string_view f_Value = f_Equals == std::string_view::npos ? std::string_view() : f_Arg.substr(f_Equals + 1);
+
+        if (f_Key == "--shapes")
+        {
+            fp_Options.m_Shapes.clear();
+
+            for (const std::string_view l_Shape : SplitList(f_Value))
+            {
+                if (l_Shape == "wide") { fp_Options.m_Shapes.push_back(SyntheticGraphShape::Wide); }
+                else if (l_Shape == "deep") { fp_Options.m_Shapes.push_back(SyntheticGraphShape::Deep); }
+                else if (l_Shape == "balanced") { fp_Options.m_Shapes.push_back(SyntheticGraphShape::Balanced); }
+                else
+                {
+                    std::fprintf(stderr, "unknown shape '%.*s'\n", static_cast<int>(l_Shape.size()), l_Shape.data());
+                    return false;
+                }
+            }
+        }
+        else if (f_Key == "--nodes")
+        {
+            fp_Options.m_NodeCounts.clear();
+
+            for (const std::string_view l_Count : SplitList(f_Value))
+            {
+                fp_Options.m_NodeCounts.push_back(ParseCount(l_Count));
+            }
+        }
+        else if (f_Key == "--roots") { fp_Options.m_RootCount = ParseCount(f_Value); }
+        else if (f_Key == "--edits") { fp_Options.m_EditCount = ParseCount(f_Value); }
+        else if (f_Key == "--codegen-nodes") { fp_Options.m_CodegenNodeCount = ParseCount(f_Value); }
+        else if (f_Key == "--chain-depth") { fp_Options.m_ChainDepth = ParseCount(f_Value); }
+        else if (f_Key == "--repetitions") { fp_Options.m_Repetitions = std::max<size_t>(1, ParseCount(f_Value)); }
+        else if (f_Key == "--seed") { fp_Options.m_Seed = ParseCount(f_Value); }
+        else if (f_Key == "--format") { fp_Options.m_IsCSV = f_Value == "csv"; }
+        else
+        {
+            std::fprintf(stderr, "unknown option '%.*s'\n", static_cast<int>(f_Arg.size()), f_Arg.data());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void
+    PrintResult(const BenchmarkResult& fp_Result, const BenchmarkOptions& fp_Options)
+{
+    const std::string_view f_Shape = GetSyntheticGraphShapeName(fp_Result.m_Shape);
+    const double f_ItemsPerSecond = fp_Result.m_Seconds > 0.0 ? fp_Result.m_Items / fp_Result.m_Seconds : 0.0;
+    const double f_BytesPerSecond = fp_Result.m_Seconds > 0.0 ? fp_Result.m_Bytes / fp_Result.m_Seconds : 0.0;
+
+    if (fp_Options.m_IsCSV)
+    {
+        std::printf
+        (
+            "%s,%.*s,%zu,%zu,%zu,%zu,%zu,%.9f,%.1f,%.1f\n",
+            fp_Result.m_Name.c_str(), static_cast<int>(f_Shape.size()), f_Shape.data(), fp_Result.m_NodeCount, fp_Options.m_RootCount,
+            WorkerPool::Pool().GetThreadCount(), fp_Result.m_Items, fp_Result.m_Bytes, fp_Result.m_Seconds, f_ItemsPerSecond, f_BytesPerSecond
+        );
+    }
+    else
+    {
+        std::printf
+        (
+            "{\"benchmark\":\"%s\",\"shape\":\"%.*s\",\"nodes\":%zu,\"roots\":%zu,\"threads\":%zu,\"items\":%zu,\"bytes\":%zu,\"seconds\":%.9f,\"items_per_sec\":%.1f,\"bytes_per_sec\":%.1f}\n",
+            fp_Result.m_Name.c_str(), static_cast<int>(f_Shape.size()), f_Shape.data(), fp_Result.m_NodeCount, fp_Options.m_RootCount,
+            WorkerPool::Pool().GetThreadCount(), fp_Result.m_Items, fp_Result.m_Bytes, fp_Result.m_Seconds, f_ItemsPerSecond, f_BytesPerSecond
+        );
+    }
+}
+
+//////////////////////////////////////////////
+// Benchmark Suite
+//////////////////////////////////////////////
+
+//One full pass over a freshly generated graph, the order matters since the later benchmarks tear the graph apart
+static void
+    RunSuite(const SyntheticGraphConfig& fp_Config, const size_t fp_EditCount, std::vector<BenchmarkResult>& fp_Results)
+{
+    ExecutionParser& f_Parser = ExecutionParser::Parser();
+    std::mt19937_64 f_Random(fp_Config.m_Seed ^ 0x9E3779B97F4A7C15ull);
+
+    auto f_Record = [&](const char* fp_Name, const size_t fp_Items, const size_t fp_Bytes, const double fp_Seconds)
+    {
+        fp_Results.push_back({ fp_Name, fp_Config.m_Shape, fp_Config.m_NodeCount, fp_Items, fp_Bytes, fp_Seconds });
+    };
+
+    f_Parser.ClearAllBlockNodes();
+
+    //////////////////// Insert ////////////////////
+
+    SyntheticBlockNodeGraph f_Graph;
+    const double f_InsertSeconds = TimeSeconds([&] { f_Graph = SyntheticBlockNodeGraph::Generate(f_Parser, fp_Config); });
+    f_Record("insert", f_Graph.m_Nodes.size(), f_Graph.m_SnippetBytes, f_InsertSeconds);
+
+    const size_t f_RootCount = f_Graph.m_Roots.size();
+    const size_t f_BodyCount = f_Graph.m_Nodes.size() - f_RootCount; //roots come first in m_Nodes
+    const size_t f_EditCount = f_BodyCount == 0 ? 0 : std::min(fp_EditCount, f_BodyCount);
+
+    auto f_RandomBodyIndex = [&] { return f_RootCount + f_Random() % f_BodyCount; };
+
+    //////////////////// Codegen ////////////////////
+
+    size_t f_ScriptBytes = 0;
+
+    const double f_ColdSeconds = TimeSeconds([&] { f_ScriptBytes = f_Parser.GenerateFullScript().size(); });
+    f_Record("codegen_cold", f_Graph.m_Nodes.size(), f_ScriptBytes, f_ColdSeconds);
+
+    const double f_WarmSeconds = TimeSeconds([&] { f_ScriptBytes = f_Parser.GenerateFullScript().size(); });
+    f_Record("codegen_warm", f_Graph.m_Nodes.size(), f_ScriptBytes, f_WarmSeconds);
+
+    uint64_t f_GraphHash = 0;
+
+    const double f_HashColdSeconds = TimeSeconds([&] { f_GraphHash = f_Parser.GetGraphHash(); }); //codegen only hashes roots that look alike, so most of the graph is still unhashed here
+    f_Record("graph_hash_cold", f_Graph.m_Nodes.size(), 0, f_HashColdSeconds);
+
+    std::vector<BlockNodeHandle> f_EditTargets(f_EditCount);
+
+    for (BlockNodeHandle& l_Target : f_EditTargets)
+    {
+        l_Target = f_Graph.m_Nodes[f_RandomBodyIndex()];
+    }
+
+    const std::string f_EditedSnippet = "edited = value + 1";
+
+    const double f_IncrementalSeconds = TimeSeconds
+    (
+        [&]
+        {
+            for (const BlockNodeHandle l_Target : f_EditTargets)
+            {
+                f_Parser.SetBlockNodeCodeSnippet(l_Target, f_EditedSnippet);
+            }
+
+            f_ScriptBytes = f_Parser.GenerateFullScript().size();
+        }
+    );
+    f_Record("codegen_incremental", f_EditCount, f_ScriptBytes, f_IncrementalSeconds);
+
+    const double f_HashIncrementalSeconds = TimeSeconds([&] { f_GraphHash ^= f_Parser.GetGraphHash(); }); //only the edited paths get rehashed
+    f_Record("graph_hash_incremental", f_EditCount, 0, f_HashIncrementalSeconds);
+
+    g_DoNotOptimize = static_cast<size_t>(f_GraphHash);
+
+    //////////////////// Root Execution Order ////////////////////
+
+    const double f_ExecutionSetupSeconds = TimeSeconds //the last root jumps to the front, every script cache is still clean so this is the index update + restitching the roots
+    (
+        [&]
+        {
+            f_Parser.SetBlockNodeInputLineNumber(f_Graph.m_Roots.back(), 0);
+            f_ScriptBytes = f_Parser.GenerateFullScript().size();
+        }
+    );
+    f_Record("execution_setup", f_RootCount, f_ScriptBytes, f_ExecutionSetupSeconds);
+
+    //////////////////// Source Map ////////////////////
+
+    const uint32_t f_ScriptLineCount = f_Parser.GetCurrentSourceMap().GetLineCount();
+    std::vector<uint32_t> f_TracebackLines(f_Graph.m_Nodes.size());
+
+    for (uint32_t& l_Line : f_TracebackLines)
+    {
+        l_Line = f_ScriptLineCount == 0 ? 0 : 1 + static_cast<uint32_t>(f_Random() % f_ScriptLineCount);
+    }
+
+    const double f_SourceMapSeconds = TimeSeconds
+    (
+        [&]
+        {
+            size_t f_Sum = 0;
+
+            for (const uint32_t l_Line : f_TracebackLines)
+            {
+                f_Sum += f_Parser.FindBlockNodeAtScriptLine(l_Line).m_Index;
+            }
+
+            g_DoNotOptimize = f_Sum;
+        }
+    );
+    f_Record("source_map_lookup", f_TracebackLines.size(), 0, f_SourceMapSeconds);
+
+    //////////////////// Multi Target Export ////////////////////
+
+    ScriptSink f_PythonExport;
+    ScriptSink f_LuaExport;
+
+    const double f_ExportSeconds = TimeSeconds //Python and Lua off the same walk, includes flattening every root since nothing has asked for a snapshot yet
+    (
+        [&]
+        {
+            f_PythonExport.Clear();
+            f_LuaExport.Clear();
+
+            f_Parser.ExportRootLevelScripts(ScriptTarget<PythonScriptBackend>{ PYTHON_SCRIPT_BACKEND, f_PythonExport }, ScriptTarget<LuaScriptBackend>{ LUA_SCRIPT_BACKEND, f_LuaExport });
+        }
+    );
+    f_Record("export_multi_target", f_Graph.m_Nodes.size(), f_PythonExport.Size() + f_LuaExport.Size(), f_ExportSeconds);
+
+    //////////////////// Optimized Codegen ////////////////////
+
+    f_Parser.SetScriptOptimizationPasses(ScriptOptimizationPasses::All); //throws every top level cache away, so this is a cold run through the passes
+
+    const double f_OptimizedSeconds = TimeSeconds([&] { f_ScriptBytes = f_Parser.GenerateFullScript().size(); });
+    f_Record("codegen_optimized", f_Graph.m_Nodes.size(), f_ScriptBytes, f_OptimizedSeconds);
+
+    f_Parser.SetScriptOptimizationPasses(ScriptOptimizationPasses::None);
+
+    //////////////////// Validate ////////////////////
+
+    size_t f_DiagnosticCount = 0;
+
+    const double f_ValidateSeconds = TimeSeconds([&] { f_DiagnosticCount = f_Parser.ValidateGraph().m_Diagnostics.size(); }); //first call at this revision, so a full walk and not the cached report
+    f_Record("validate", f_Graph.m_Nodes.size(), 0, f_ValidateSeconds);
+
+    g_DoNotOptimize = f_DiagnosticCount; //the generator drops else nodes anywhere, so random graphs do come with orphaned else diagnostics
+
+    //////////////////// Lookup ////////////////////
+
+    std::vector<BlockNodeHandle> f_LookupOrder = f_Graph.m_Nodes;
+    std::shuffle(f_LookupOrder.begin(), f_LookupOrder.end(), f_Random); //random order so we're not just streaming through the slot map
+
+    const double f_LookupSeconds = TimeSeconds
+    (
+        [&]
+        {
+            size_t f_Sum = 0;
+
+            for (const BlockNodeHandle l_Handle : f_LookupOrder)
+            {
+                f_Sum += f_Parser.FindBlockNode(l_Handle)->m_Children.size();
+            }
+
+            g_DoNotOptimize = f_Sum;
+        }
+    );
+    f_Record("lookup", f_LookupOrder.size(), 0, f_LookupSeconds);
+
+    //////////////////// Reparent ////////////////////
+
+    //new parents sit at the same depth as the old ones, so the graph keeps its shape (and deep graphs don't get any deeper) no matter how many edits run
+    struct ReparentEdit
+    {
+        BlockNodeHandle m_Node;
+        BlockNodeHandle m_NewParent;
+    };
+
+    std::vector<std::vector<size_t>> f_NodesByDepth;
+
+    for (size_t l_Index = 0; l_Index < f_Graph.m_Nodes.size(); l_Index++)
+    {
+        if (f_Graph.m_Depths[l_Index] >= f_NodesByDepth.size())
+        {
+            f_NodesByDepth.resize(f_Graph.m_Depths[l_Index] + 1);
+        }
+
+        f_NodesByDepth[f_Graph.m_Depths[l_Index]].push_back(l_Index);
+    }
+
+    std::vector<ReparentEdit> f_ReparentEdits(f_EditCount);
+
+    for (ReparentEdit& l_Edit : f_ReparentEdits)
+    {
+        const size_t f_Node = f_RandomBodyIndex();
+        const std::vector<size_t>& f_Candidates = f_NodesByDepth[f_Graph.m_Depths[f_Node] - 1];
+
+        l_Edit = { f_Graph.m_Nodes[f_Node], f_Graph.m_Nodes[f_Candidates[f_Random() % f_Candidates.size()]] };
+    }
+
+    const double f_ReparentSeconds = TimeSeconds
+    (
+        [&]
+        {
+            for (const ReparentEdit& l_Edit : f_ReparentEdits)
+            {
+                f_Parser.ReparentBlockNode(l_Edit.m_Node, l_Edit.m_NewParent);
+            }
+        }
+    );
+    f_Record("reparent", f_ReparentEdits.size(), 0, f_ReparentSeconds);
+
+    //////////////////// Remove ////////////////////
+
+    for (BlockNodeHandle& l_Target : f_EditTargets)
+    {
+        l_Target = f_Graph.m_Nodes[f_RandomBodyIndex()];
+    }
+
+    const double f_RemoveSeconds = TimeSeconds
+    (
+        [&]
+        {
+            for (const BlockNodeHandle l_Target : f_EditTargets)
+            {
+                f_Parser.FindAndRemoveBlockNode(l_Target); //targets inside an already removed branch are stale by now and bail out early, same as in the editor
+            }
+        }
+    );
+    f_Record("remove", f_EditTargets.size(), 0, f_RemoveSeconds);
+
+    //////////////////// Undo / Redo ////////////////////
+
+    const size_t f_UndoStepCount = f_EditTargets.size() + f_ReparentEdits.size(); //back through the removes (whole branches coming back) and the reparents, removes that hit an already removed branch weren't recorded so it can reach into the snippet edits
+    size_t f_UndoneStepCount = 0;
+
+    const double f_UndoSeconds = TimeSeconds
+    (
+        [&]
+        {
+            while (f_UndoneStepCount < f_UndoStepCount and f_Parser.Undo())
+            {
+                f_UndoneStepCount++;
+            }
+        }
+    );
+    f_Record("undo", f_UndoneStepCount, 0, f_UndoSeconds);
+
+    const double f_RedoSeconds = TimeSeconds
+    (
+        [&]
+        {
+            for (size_t l_Step = 0; l_Step < f_UndoneStepCount; l_Step++)
+            {
+                f_Parser.Redo();
+            }
+        }
+    );
+    f_Record("redo", f_UndoneStepCount, 0, f_RedoSeconds);
+
+    //////////////////// Clear ////////////////////
+
+    const double f_ClearSeconds = TimeSeconds([&] { f_Parser.ClearAllBlockNodes(); });
+    f_Record("clear", f_Graph.m_Nodes.size(), 0, f_ClearSeconds);
+}
+
+//The two ways a root gets turned into a script with every cache out of the way, both emit the exact same bytes
+static void
+    RunCodegenSuite(const SyntheticGraphConfig& fp_Config, std::vector<BenchmarkResult>& fp_Results)
+{
+    ExecutionParser& f_Parser = ExecutionParser::Parser();
+
+    auto f_Record = [&](const char* fp_Name, const size_t fp_Items, const size_t fp_Bytes, const double fp_Seconds)
+    {
+        fp_Results.push_back({ fp_Name, fp_Config.m_Shape, fp_Config.m_NodeCount, fp_Items, fp_Bytes, fp_Seconds });
+    };
+
+    f_Parser.ClearAllBlockNodes();
+
+    const SyntheticBlockNodeGraph f_Graph = SyntheticBlockNodeGraph::Generate(f_Parser, fp_Config);
+    BlockNodeTraversal f_Traversal;
+    ScriptSink f_DFSSink;
+
+    const double f_DFSSeconds = TimeSeconds
+    (
+        [&]
+        {
+            for (const BlockNodeHandle l_Root : f_Graph.m_Roots)
+            {
+                f_Traversal.Walk(static_cast<const BlockNode*>(f_Parser.FindBlockNode(l_Root)), [&f_DFSSink](const BlockNode* fp_Node, const unsigned int fp_Depth) { fp_Node->EmitScript(f_DFSSink, fp_Depth); });
+            }
+        }
+    );
+    f_Record("codegen_dfs", f_Graph.m_Nodes.size(), f_DFSSink.Size(), f_DFSSeconds);
+
+    std::vector<const FlattenedBlockNodeTree*> f_Trees(f_Graph.m_Roots.size());
+
+    const double f_FlattenSeconds = TimeSeconds
+    (
+        [&]
+        {
+            for (size_t l_Index = 0; l_Index < f_Trees.size(); l_Index++)
+            {
+                f_Trees[l_Index] = f_Parser.CompileBlockNodeTree(f_Graph.m_Roots[l_Index]);
+            }
+        }
+    );
+    f_Record("flatten", f_Graph.m_Nodes.size(), 0, f_FlattenSeconds);
+
+    ScriptSink f_FlattenedSink;
+
+    const double f_FlattenedSeconds = TimeSeconds
+    (
+        [&]
+        {
+            for (const FlattenedBlockNodeTree* l_Tree : f_Trees)
+            {
+                l_Tree->EmitScript(f_FlattenedSink);
+            }
+        }
+    );
+    f_Record("codegen_flattened", f_Graph.m_Nodes.size(), f_FlattenedSink.Size(), f_FlattenedSeconds);
+
+    if (f_DFSSink.View() != f_FlattenedSink.View())
+    {
+        std::fprintf(stderr, "codegen_dfs and codegen_flattened emitted different scripts for the %zu node %s graph\n", f_Graph.m_Nodes.size(), GetSyntheticGraphShapeName(fp_Config.m_Shape).data());
+    }
+
+    f_Parser.ClearAllBlockNodes();
+}
+
+//Every walk over one chain as deep as the graph is big, anything still recursing would overflow the call stack long before 1M.
+//No codegen in here, the indentation alone would make the script quadratic in the depth
+static void
+    RunChainSuite(const SyntheticGraphConfig& fp_Config, std::vector<BenchmarkResult>& fp_Results)
+{
+    ExecutionParser& f_Parser = ExecutionParser::Parser();
+
+    auto f_Record = [&](const char* fp_Name, const size_t fp_Items, const double fp_Seconds)
+    {
+        fp_Results.push_back({ fp_Name, fp_Config.m_Shape, fp_Config.m_NodeCount, fp_Items, 0, fp_Seconds });
+    };
+
+    f_Parser.ClearAllBlockNodes();
+
+    SyntheticBlockNodeGraph f_Graph;
+    const double f_InsertSeconds = TimeSeconds([&] { f_Graph = SyntheticBlockNodeGraph::Generate(f_Parser, fp_Config); });
+    f_Record("chain_insert", f_Graph.m_Nodes.size(), f_InsertSeconds);
+
+    if (f_Graph.m_Nodes.size() < 2)
+    {
+        return;
+    }
+
+    const BlockNodeHandle f_Top = f_Graph.m_Nodes[1]; //first body node, the whole chain hangs off it
+    const BlockNodeHandle f_Bottom = f_Graph.m_Nodes.back();
+
+    uint64_t f_GraphHash = 0;
+
+    const double f_HashSeconds = TimeSeconds([&] { f_GraphHash = f_Parser.GetGraphHash(); });
+    f_Record("chain_hash", f_Graph.m_Nodes.size(), f_HashSeconds);
+
+    const double f_RehashSeconds = TimeSeconds
+    (
+        [&]
+        {
+            f_Parser.SetBlockNodeCodeSnippet(f_Bottom, "edited = value + 1");
+            f_GraphHash ^= f_Parser.GetGraphHash(); //the dirty path is the whole chain
+        }
+    );
+    f_Record("chain_rehash", f_Graph.m_Nodes.size(), f_RehashSeconds);
+
+    g_DoNotOptimize = static_cast<size_t>(f_GraphHash);
+
+    const double f_ValidateSeconds = TimeSeconds([&] { g_DoNotOptimize = f_Parser.ValidateGraph().m_Diagnostics.size(); });
+    f_Record("chain_validate", f_Graph.m_Nodes.size(), f_ValidateSeconds);
+
+    const double f_MoveSeconds = TimeSeconds([&] { f_Parser.ReparentBlockNode(f_Top, {}); }); //every cached offset below was relative to the old root
+    f_Record("chain_move", f_Graph.m_Nodes.size() - 1, f_MoveSeconds);
+
+    const double f_RemoveSeconds = TimeSeconds([&] { f_Parser.FindAndRemoveBlockNode(f_Top); }); //retired, the history keeps it for undo
+    f_Record("chain_remove", f_Graph.m_Nodes.size() - 1, f_RemoveSeconds);
+
+    const double f_UndoSeconds = TimeSeconds([&] { f_Parser.Undo(); });
+    f_Record("chain_undo", f_Graph.m_Nodes.size() - 1, f_UndoSeconds);
+
+    f_Parser.SetUndoHistoryLimit(0); //nothing to keep it around for, so removing hands the chain straight back to the arena
+
+    const double f_DestroySeconds = TimeSeconds([&] { f_Parser.FindAndRemoveBlockNode(f_Top); });
+    f_Record("chain_destroy", f_Graph.m_Nodes.size() - 1, f_DestroySeconds);
+
+    f_Parser.SetUndoHistoryLimit(ExecutionParser::DEFAULT_UNDO_HISTORY_LIMIT);
+    f_Parser.ClearAllBlockNodes();
+}
+
+template<typename Suite>
+static void
+    RunAndPrintFastest(const BenchmarkOptions& fp_Options, Suite&& fp_Suite)
+{
+    std::vector<BenchmarkResult> f_Fastest; //every suite records in the same order each run, so repetitions line up index for index
+
+    for (size_t l_Repetition = 0; l_Repetition < fp_Options.m_Repetitions; l_Repetition++)
+    {
+        std::vector<BenchmarkResult> f_Results;
+        fp_Suite(f_Results);
+
+        if (f_Fastest.empty())
+        {
+            f_Fastest = std::move(f_Results);
+            continue;
+        }
+
+        for (size_t l_Index = 0; l_Index < f_Results.size(); l_Index++)
+        {
+            if (f_Results[l_Index].m_Seconds < f_Fastest[l_Index].m_Seconds)
+            {
+                f_Fastest[l_Index] = f_Results[l_Index];
+            }
+        }
+    }
+
+    for (const BenchmarkResult& l_Result : f_Fastest)
+    {
+        PrintResult(l_Result, fp_Options);
+    }
+
+    std::fflush(stdout);
+}
+
+//////////////////////////////////////////////
+// MAIN FUNCTION
+//////////////////////////////////////////////
+int
+    main(int fp_ArgCount, const char* fp_ArgVector[])
+{
+    BenchmarkOptions f_Options;
+
+    if (not ParseOptions(fp_ArgCount, fp_ArgVector, f_Options))
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (f_Options.m_IsCSV)
+    {
+        std::printf("benchmark,shape,nodes,roots,threads,items,bytes,seconds,items_per_sec,bytes_per_sec\n");
+    }
+
+    for (const SyntheticGraphShape l_Shape : f_Options.m_Shapes)
+    {
+        for (const size_t l_NodeCount : f_Options.m_NodeCounts)
+        {
+            SyntheticGraphConfig f_Config;
+            f_Config.m_Shape = l_Shape;
+            f_Config.m_NodeCount = l_NodeCount;
+            f_Config.m_RootCount = f_Options.m_RootCount;
+            f_Config.m_Seed = f_Options.m_Seed;
+
+            RunAndPrintFastest(f_Options, [&](std::vector<BenchmarkResult>& fp_Results) { RunSuite(f_Config, f_Options.m_EditCount, fp_Results); });
+        }
+    }
+
+    for (const SyntheticGraphShape l_Shape : f_Options.m_CodegenNodeCount > 0 ? f_Options.m_Shapes : std::vector<SyntheticGraphShape>())
+    {
+        SyntheticGraphConfig f_Config;
+        f_Config.m_Shape = l_Shape;
+        f_Config.m_NodeCount = f_Options.m_CodegenNodeCount;
+        f_Config.m_RootCount = f_Options.m_RootCount;
+        f_Config.m_Seed = f_Options.m_Seed;
+
+        RunAndPrintFastest(f_Options, [&](std::vector<BenchmarkResult>& fp_Results) { RunCodegenSuite(f_Config, fp_Results); });
+    }
+
+    if (f_Options.m_ChainDepth > 0)
+    {
+        SyntheticGraphConfig f_Config;
+        f_Config.m_Shape = SyntheticGraphShape::Chain;
+        f_Config.m_NodeCount = f_Options.m_ChainDepth + 1; //plus the root
+        f_Config.m_RootCount = 1;
+        f_Config.m_Seed = f_Options.m_Seed;
+
+        RunAndPrintFastest(f_Options, [&](std::vector<BenchmarkResult>& fp_Results) { RunChainSuite(f_Config, fp_Results); });
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,349 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+/*
+Benchmarks the JSON lexer and Serializer loads on synthetic documents and prints one record per measurement, throughput is in MB/s.
+
+    PrincessSerializerBenchmarks [--sizes=1k,10k,100k,1M,10M,100M] [--repetitions=3] [--seed=1337] [--format=json|csv]
+
+Sizes are in bytes and take k/M suffixes, the generated document stops at the first block past that size. Every measurement keeps
+its fastest repetition, json output is one object per line.
+load_file is deserialize again but starting from the document written out to a temporary .json file, so it includes opening the file.
+*/
+#include "Serializer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Princess;
+
+//////////////////////////////////////////////
+// Benchmark Results
+//////////////////////////////////////////////
+
+struct BenchmarkResult
+{
+    std::string m_Name;
+    size_t m_Bytes = 0; //size of the document
+    size_t m_Tokens = 0;
+    double m_Seconds = 0.0;
+};
+
+struct BenchmarkOptions
+{
+    std::vector<size_t> m_Sizes = { 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000 };
+
+    size_t m_Repetitions = 3;
+    uint64_t m_Seed = 1337;
+
+    bool m_IsCSV = false;
+};
+
+static volatile size_t g_DoNotOptimize = 0; //token counts feed into this so the compiler can't drop the lexing
+
+//////////////////////////////////////////////
+// Helpers
+//////////////////////////////////////////////
+
+template<typename Function>
+static double
+    TimeSeconds(Function&& fp_Function)
+{
+    const auto f_Start = std::chrono::steady_clock::now();
+    fp_Function();
+    const auto f_End = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double>(f_End - f_Start).count();
+}
+
+static size_t
+    ParseCount(std::string_view fp_Text) //"10M" -> 10'000'000
+{
+    size_t f_Multiplier = 1;
+
+    if (not fp_Text.empty() and (fp_Text.back() == 'k' or fp_Text.back() == 'K'))
+    {
+        f_Multiplier = 1'000;
+        fp_Text.remove_suffix(1);
+    }
+    else if (not fp_Text.empty() and (fp_Text.back() == 'm' or fp_Text.back() == 'M'))
+    {
+        f_Multiplier = 1'000'000;
+        fp_Text.remove_suffix(1);
+    }
+
+    return std::strtoull(std::string(fp_Text).c_str(), nullptr, 10) * f_Multiplier;
+}
+
+static std::vector<std::string_view>
+    SplitList(std::string_view fp_Text)
+{
+    std::vector<std::string_view> f_Items;
+
+    while (not fp_Text.empty())
+    {
+        const size_t f_Comma = fp_Text.find(',');
+        f_Items.push_back(fp_Text.substr(0, f_Comma));
+
+        if (f_Comma == std::string_view::npos)
+        {
+            break;
+        }
+
+        fp_Text.remove_prefix(f_Comma + 1);
+    }
+
+    return f_Items;
+}
+
+static bool
+    ParseOptions(const int fp_ArgCount, const char* fp_ArgVector[], BenchmarkOptions& fp_Options)
+{
+    for (int l_Arg = 1; l_Arg < fp_ArgCount; l_Arg++)
+    {
+        const std::string_view f_Arg = fp_ArgVector[l_Arg];
+        const size_t f_Equals = f_Arg.find('=');
+        const std::string_view f_Key = f_Arg.substr(0, f_Equals);
+        const std::string_view f_Value = f_Equals == std::string_view::npos ? std::string_view() : f_Arg.substr(f_Equals + 1);
+
+        if (f_Key == "--sizes")
+        {
+            fp_Options.m_Sizes.clear();
+
+            for (const std::string_view l_Size : SplitList(f_Value))
+            {
+                fp_Options.m_Sizes.push_back(ParseCount(l_Size));
+            }
+        }
+        else if (f_Key == "--repetitions") { fp_Options.m_Repetitions = std::max<size_t>(1, ParseCount(f_Value)); }
+        else if (f_Key == "--seed") { fp_Options.m_Seed = ParseCount(f_Value); }
+        else if (f_Key == "--format") { fp_Options.m_IsCSV = f_Value == "csv"; }
+        else
+        {
+            std::fprintf(stderr, "unknown option '%.*s'\n", static_cast<int>(f_Arg.size()), f_Arg.data());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void
+    PrintResult(const BenchmarkResult& fp_Result, const BenchmarkOptions& fp_Options)
+{
+    const double f_TokensPerSecond = fp_Result.m_Seconds > 0.0 ? fp_Result.m_Tokens / fp_Result.m_Seconds : 0.0;
+    const double f_MegabytesPerSecond = fp_Result.m_Seconds > 0.0 ? fp_Result.m_Bytes / fp_Result.m_Seconds / 1'000'000.0 : 0.0;
+
+    if (fp_Options.m_IsCSV)
+    {
+        std::printf
+        (
+            "%s,%zu,%zu,%.9f,%.1f,%.1f\n",
+            fp_Result.m_Name.c_str(), fp_Result.m_Bytes, fp_Result.m_Tokens, fp_Result.m_Seconds, f_TokensPerSecond, f_MegabytesPerSecond
+        );
+    }
+    else
+    {
+        std::printf
+        (
+            "{\"benchmark\":\"%s\",\"bytes\":%zu,\"tokens\":%zu,\"seconds\":%.9f,\"tokens_per_sec\":%.1f,\"mb_per_sec\":%.1f}\n",
+            fp_Result.m_Name.c_str(), fp_Result.m_Bytes, fp_Result.m_Tokens, fp_Result.m_Seconds, f_TokensPerSecond, f_MegabytesPerSecond
+        );
+    }
+}
+
+//////////////////////////////////////////////
+// Synthetic JSON
+//////////////////////////////////////////////
+
+//Looks like a saved project, an array of block objects with escaped snippets, signed and decimal numbers, bools, nulls and nested arrays
+static std::string
+    GenerateDocument(const size_t fp_TargetBytes, const uint64_t fp_Seed)
+{
+    std::mt19937_64 f_Random(fp_Seed);
+    std::string f_Document;
+    f_Document.reserve(fp_TargetBytes + 512);
+
+    f_Document += "{\n\t\"version\": 1,\n\t\"blocks\": [\n";
+
+    for (size_t l_Block = 0; f_Document.size() < fp_TargetBytes; l_Block++)
+    {
+        if (l_Block > 0)
+        {
+            f_Document += ",\n";
+        }
+
+        const size_t f_ChildCount = f_Random() % 4;
+
+        f_Document += "\t\t{\n\t\t\t\"name\": \"block_" + std::to_string(l_Block) + "\",\n";
+        f_Document += "\t\t\t\"snippet\": \"for i in range(" + std::to_string(f_Random() % 1000) + "):\\n\\tprint(\\\"value: \\\" + str(i))\",\n";
+        f_Document += "\t\t\t\"x\": " + std::to_string(f_Random() % 4096) + "." + std::to_string(f_Random() % 100);
+        f_Document += ", \"y\": -" + std::to_string(f_Random() % 4096);
+        f_Document += ", \"collapsed\": " + std::string(f_Random() % 2 == 0 ? "true" : "false") + ",\n";
+        f_Document += "\t\t\t\"parent\": " + (l_Block == 0 ? std::string("null") : std::to_string(f_Random() % l_Block)) + ",\n";
+        f_Document += "\t\t\t\"children\": [";
+
+        for (size_t l_Child = 0; l_Child < f_ChildCount; l_Child++)
+        {
+            f_Document += (l_Child > 0 ? ", " : "") + std::to_string(l_Block + 1 + f_Random() % 64);
+        }
+
+        f_Document += "]\n\t\t}";
+    }
+
+    f_Document += "\n\t]\n}\n";
+
+    return f_Document;
+}
+
+struct SyntheticBlock //what the deserialize benchmark binds each block object to, "parent" is left out since it's sometimes null
+{
+    std::string name;
+    std::string snippet;
+    double x = 0.0;
+    int64_t y = 0;
+    bool collapsed = false;
+    std::vector<uint64_t> children;
+
+    SERIALIZABLE_FIELDS(name, snippet, x, y, collapsed, children)
+};
+
+struct SyntheticDocument
+{
+    uint64_t version = 0;
+    std::vector<SyntheticBlock> blocks;
+
+    SERIALIZABLE_FIELDS(version, blocks)
+};
+
+//////////////////////////////////////////////
+// Benchmark Suite
+//////////////////////////////////////////////
+
+static bool
+    RunSuite(const std::string& fp_Document, const std::string& fp_DocumentPath, Logger& fp_Logger, std::vector<BenchmarkResult>& fp_Results)
+{
+    bool f_IsValid = true;
+
+    std::vector<JSONToken> f_Tokens;
+    const double f_TokenizeSeconds = TimeSeconds([&] { f_IsValid = JSONLexer(fp_Document, &fp_Logger).Tokenize(f_Tokens) and f_IsValid; });
+    fp_Results.push_back({ "lex_tokenize", fp_Document.size(), f_Tokens.size(), f_TokenizeSeconds });
+
+    size_t f_TokenCount = 0;
+
+    const double f_NextSeconds = TimeSeconds
+    (
+        [&]
+        {
+            JSONLexer f_Lexer(fp_Document, &fp_Logger);
+            JSONToken f_Token;
+
+            do
+            {
+                f_IsValid = f_Lexer.Next(f_Token) and f_IsValid;
+                f_TokenCount++;
+            }
+            while (f_IsValid and f_Token.m_Type != JSONTokenType::ENDF);
+        }
+    );
+    fp_Results.push_back({ "lex_next", fp_Document.size(), f_TokenCount, f_NextSeconds });
+
+    Serializer f_Serializer;
+    SyntheticDocument f_Loaded;
+
+    const double f_DeserializeSeconds = TimeSeconds([&] { f_IsValid = f_Serializer.FromJSONString(f_Loaded, fp_Document, &fp_Logger) and f_IsValid; });
+    fp_Results.push_back({ "deserialize", fp_Document.size(), f_Tokens.size(), f_DeserializeSeconds });
+
+    SyntheticDocument f_LoadedFromFile;
+
+    const double f_LoadSeconds = TimeSeconds([&] { f_IsValid = f_Serializer.FromJSON(f_LoadedFromFile, fp_DocumentPath, &fp_Logger) and f_IsValid; });
+    fp_Results.push_back({ "load_file", fp_Document.size(), f_Tokens.size(), f_LoadSeconds });
+
+    g_DoNotOptimize = f_Tokens.size() + f_TokenCount + f_Loaded.blocks.size() + f_LoadedFromFile.blocks.size();
+
+    return f_IsValid;
+}
+
+//////////////////////////////////////////////
+// MAIN FUNCTION
+//////////////////////////////////////////////
+int
+    main(int fp_ArgCount, const char* fp_ArgVector[])
+{
+    BenchmarkOptions f_Options;
+
+    if (not ParseOptions(fp_ArgCount, fp_ArgVector, f_Options))
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (f_Options.m_IsCSV)
+    {
+        std::printf("benchmark,bytes,tokens,seconds,tokens_per_sec,mb_per_sec\n");
+    }
+
+    Logger f_Logger; //the documents are always valid, so nothing ever gets logged
+    const std::string f_DocumentPath = (std::filesystem::temp_directory_path() / "PrincessSerializerBenchmark.json").string();
+    std::error_code f_Error; //cleaning up the temporary file is best effort
+
+    for (const size_t l_Size : f_Options.m_Sizes)
+    {
+        const std::string f_Document = GenerateDocument(l_Size, f_Options.m_Seed);
+        std::vector<BenchmarkResult> f_Fastest;
+
+        if (not std::ofstream(f_DocumentPath, std::ios::out | std::ios::binary).write(f_Document.data(), static_cast<std::streamsize>(f_Document.size())))
+        {
+            std::fprintf(stderr, "failed to write the generated document to %s\n", f_DocumentPath.c_str());
+            return EXIT_FAILURE;
+        }
+
+        for (size_t l_Repetition = 0; l_Repetition < f_Options.m_Repetitions; l_Repetition++)
+        {
+            std::vector<BenchmarkResult> f_Results;
+
+            if (not RunSuite(f_Document, f_DocumentPath, f_Logger, f_Results))
+            {
+                std::fprintf(stderr, "failed to lex the generated %zu byte document\n", f_Document.size());
+                std::filesystem::remove(f_DocumentPath, f_Error);
+                return EXIT_FAILURE;
+            }
+
+            for (size_t l_Index = 0; l_Index < f_Results.size(); l_Index++)
+            {
+                if (f_Fastest.size() <= l_Index)
+                {
+                    f_Fastest.push_back(f_Results[l_Index]);
+                }
+                else if (f_Results[l_Index].m_Seconds < f_Fastest[l_Index].m_Seconds)
+                {
+                    f_Fastest[l_Index] = f_Results[l_Index];
+                }
+            }
+        }
+
+        for (const BenchmarkResult& l_Result : f_Fastest)
+        {
+            PrintResult(l_Result, f_Options);
+        }
+
+        std::fflush(stdout);
+    }
+
+    std::filesystem::remove(f_DocumentPath, f_Error);
+
+    return EXIT_SUCCESS;
+}
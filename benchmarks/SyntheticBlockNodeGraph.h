@@ -0,0 +1,226 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Parsers/ExecutionParser.h"
+
+namespace Princess {
+
+    //////////////////////////////////////////////
+    // Synthetic Graph Config
+    //////////////////////////////////////////////
+
+    enum class SyntheticGraphShape : unsigned char
+    {
+        Wide, //every node hangs straight off its root
+        Deep, //chains nested up to m_MaxDepth, then a new chain starts under the root
+        Balanced, //complete m_BranchingFactor-ary tree per root
+        Chain //one unbroken chain per root, no depth cap, so its script is quadratic in the depth and only walks get benchmarked on it
+    };
+
+    struct SyntheticGraphConfig
+    {
+        SyntheticGraphShape m_Shape = SyntheticGraphShape::Balanced;
+
+        size_t m_NodeCount = 100'000; //roots included
+        size_t m_RootCount = 64;
+        unsigned int m_MaxDepth = 256; //only used by Deep, keeps the indentation (and the script size) from going quadratic
+        unsigned int m_BranchingFactor = 4; //only used by Balanced
+
+        size_t m_MinSnippetLength = 12; //roughly one line of hand written python
+        size_t m_MaxSnippetLength = 80;
+
+        uint64_t m_Seed = 1337;
+    };
+
+    [[nodiscard]] inline std::string_view
+        GetSyntheticGraphShapeName(const SyntheticGraphShape fp_Shape)
+    {
+        switch (fp_Shape)
+        {
+        case SyntheticGraphShape::Wide: return "wide";
+        case SyntheticGraphShape::Deep: return "deep";
+        case SyntheticGraphShape::Balanced: return "balanced";
+        case SyntheticGraphShape::Chain: return "chain";
+        }
+
+        return "unknown";
+    }
+
+    //////////////////////////////////////////////
+    // Synthetic Block Node Graph
+    //////////////////////////////////////////////
+    /*
+    Fills the ExecutionParser with a reproducible graph through the same public API the editor uses, so anything measured on it (including
+    the generation itself) is what a user loading a project of that shape would hit. Same config + same seed = same graph, node for node.
+    */
+
+    struct SyntheticBlockNodeGraph
+    {
+    public:
+        std::vector<BlockNodeHandle> m_Roots = {};
+        std::vector<BlockNodeHandle> m_Nodes = {}; //every node including the roots, in creation order
+        std::vector<unsigned int> m_Depths = {}; //parallel to m_Nodes, roots are depth 0
+
+        size_t m_SnippetBytes = 0;
+
+    public:
+        static SyntheticBlockNodeGraph
+            Generate(ExecutionParser& fp_Parser, const SyntheticGraphConfig& fp_Config)
+        {
+            SyntheticBlockNodeGraph f_Graph;
+            std::mt19937_64 f_Random(fp_Config.m_Seed);
+
+            const std::vector<std::string> f_SnippetPool = BuildSnippetPool(fp_Config, f_Random); //picking out of a pool is way cheaper than building 10M unique strings and the lengths still vary
+
+            const size_t f_RootCount = std::max<size_t>(1, std::min(fp_Config.m_RootCount, fp_Config.m_NodeCount));
+            const size_t f_BodyCount = fp_Config.m_NodeCount - f_RootCount;
+
+            f_Graph.m_Roots.reserve(f_RootCount);
+            f_Graph.m_Nodes.reserve(fp_Config.m_NodeCount);
+            f_Graph.m_Depths.reserve(fp_Config.m_NodeCount);
+
+            std::vector<unsigned int> f_InputLineNumbers(f_RootCount);
+
+            for (size_t l_Index = 0; l_Index < f_RootCount; l_Index++)
+            {
+                f_InputLineNumbers[l_Index] = static_cast<unsigned int>(l_Index);
+            }
+
+            std::shuffle(f_InputLineNumbers.begin(), f_InputLineNumbers.end(), f_Random); //creation order != execution order, so the execution order index has real work to do
+
+            for (size_t l_Root = 0; l_Root < f_RootCount; l_Root++)
+            {
+                FunctionBlockNode* f_Root = fp_Parser.CreateBlockNode<FunctionBlockNode>("root_" + std::to_string(l_Root));
+                fp_Parser.SetBlockNodeInputLineNumber(f_Root->m_ID, f_InputLineNumbers[l_Root]);
+                fp_Parser.FlagBlockNodeForRootLevelExecution(f_Root->m_ID);
+
+                f_Graph.m_Roots.push_back(f_Root->m_ID);
+                f_Graph.m_Nodes.push_back(f_Root->m_ID);
+                f_Graph.m_Depths.push_back(0);
+            }
+
+            //per root bookkeeping for picking parents, body nodes are dealt out round robin so every root ends up about the same size
+            std::vector<std::vector<size_t>> f_RootMembers(f_RootCount); //indices into m_Nodes, [0] is the root itself
+
+            for (size_t l_Root = 0; l_Root < f_RootCount; l_Root++)
+            {
+                f_RootMembers[l_Root].push_back(l_Root);
+            }
+
+            for (size_t l_Body = 0; l_Body < f_BodyCount; l_Body++)
+            {
+                const size_t f_Root = l_Body % f_RootCount;
+                std::vector<size_t>& f_Members = f_RootMembers[f_Root];
+
+                size_t f_ParentIndex = f_Members.front();
+
+                switch (fp_Config.m_Shape)
+                {
+                case SyntheticGraphShape::Wide:
+                    break;
+
+                case SyntheticGraphShape::Deep:
+                    if (f_Graph.m_Depths[f_Members.back()] < fp_Config.m_MaxDepth)
+                    {
+                        f_ParentIndex = f_Members.back();
+                    }
+                    break;
+
+                case SyntheticGraphShape::Balanced:
+                    f_ParentIndex = f_Members[(f_Members.size() - 1) / std::max(1u, fp_Config.m_BranchingFactor)];
+                    break;
+
+                case SyntheticGraphShape::Chain:
+                    f_ParentIndex = f_Members.back();
+                    break;
+                }
+
+                BlockNode* f_Node = CreateRandomBlockNode(fp_Parser, f_Random, l_Body);
+                const std::string& f_Snippet = f_SnippetPool[f_Random() % f_SnippetPool.size()];
+
+                fp_Parser.SetBlockNodeCodeSnippet(f_Node->m_ID, f_Snippet); //a few constructors drop their snippet, so always go through the setter
+                fp_Parser.ReparentBlockNode(f_Node->m_ID, f_Graph.m_Nodes[f_ParentIndex]);
+
+                f_Members.push_back(f_Graph.m_Nodes.size());
+                f_Graph.m_Nodes.push_back(f_Node->m_ID);
+                f_Graph.m_Depths.push_back(f_Graph.m_Depths[f_ParentIndex] + 1);
+                f_Graph.m_SnippetBytes += f_Snippet.size();
+            }
+
+            return f_Graph;
+        }
+
+    private:
+        static std::vector<std::string>
+            BuildSnippetPool(const SyntheticGraphConfig& fp_Config, std::mt19937_64& fp_Random)
+        {
+            static constexpr std::string_view TOKENS[] =
+            {
+                "value", "index", "count", "total", "result", "+", "-", "*", "==", "<", "and", "len(items)", "compute(x)", "42", "0.5", "name", "self.data[i]"
+            };
+
+            const size_t f_MinLength = std::min(fp_Config.m_MinSnippetLength, fp_Config.m_MaxSnippetLength);
+            const size_t f_MaxLength = std::max(fp_Config.m_MinSnippetLength, fp_Config.m_MaxSnippetLength);
+
+            std::uniform_int_distribution<size_t> f_LengthDistribution(f_MinLength, f_MaxLength);
+            std::vector<std::string> f_Pool(1024);
+
+            for (std::string& l_Snippet : f_Pool)
+            {
+                const size_t f_Length = f_LengthDistribution(fp_Random);
+
+                while (l_Snippet.size() < f_Length)
+                {
+                    if (not l_Snippet.empty())
+                    {
+                        l_Snippet += ' ';
+                    }
+
+                    l_Snippet += TOKENS[fp_Random() % std::size(TOKENS)];
+                }
+
+                l_Snippet.resize(f_Length);
+            }
+
+            return f_Pool;
+        }
+
+        static BlockNode*
+            CreateRandomBlockNode(ExecutionParser& fp_Parser, std::mt19937_64& fp_Random, const size_t fp_Index)
+        {
+            const std::string f_Name = "node_" + std::to_string(fp_Index);
+
+            switch (fp_Random() % 20) //weighted towards plain statements like real scripts are
+            {
+            case 0: case 1: case 2:
+                return fp_Parser.CreateBlockNode<IfBlockNode>("");
+            case 3:
+                return fp_Parser.CreateBlockNode<ElseBlockNode>("");
+            case 4: case 5:
+                return fp_Parser.CreateBlockNode<WhileLoopBlockNode>(f_Name, "");
+            case 6: case 7:
+                return fp_Parser.CreateBlockNode<ForEachBlockNode>("");
+            case 8: case 9: case 10: case 11:
+                return fp_Parser.CreateBlockNode<VariableDefinitionBlockNode>(f_Name);
+            default:
+                return fp_Parser.CreateBlockNode<BlockNode>(f_Name, "");
+            }
+        }
+    };
+}
@@ -0,0 +1,75 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace Princess {
+
+    //////////////////////////////////////////////
+    // Atomic Bitset
+    //////////////////////////////////////////////
+    /*
+    Fixed size bitset several threads can set bits in at once, one bit per slot index so a visited set over the whole graph is SlotCount() / 8
+    bytes instead of a hash set. Everything is relaxed, the WorkerPool join is what publishes the bits to whoever reads them afterwards.
+    */
+
+    class AtomicBitset
+    {
+    public:
+        void
+            Reset(const size_t fp_BitCount) //clears every bit, only reallocates when the size changes
+        {
+            const size_t f_WordCount = (fp_BitCount + 63) / 64;
+
+            if (f_WordCount != pm_Words.size())
+            {
+                pm_Words = std::vector<std::atomic<uint64_t>>(f_WordCount); //atomics can't be resized in place
+            }
+            else
+            {
+                for (std::atomic<uint64_t>& l_Word : pm_Words)
+                {
+                    l_Word.store(0, std::memory_order_relaxed);
+                }
+            }
+
+            pm_BitCount = fp_BitCount;
+        }
+
+        bool
+            TestAndSet(const size_t fp_Bit) //returns whether the bit was already set, exactly one caller sees false for each bit
+        {
+            const uint64_t f_Mask = uint64_t(1) << (fp_Bit & 63);
+            return (pm_Words[fp_Bit >> 6].fetch_or(f_Mask, std::memory_order_relaxed) & f_Mask) != 0;
+        }
+
+        [[nodiscard]] bool
+            Test(const size_t fp_Bit)
+            const
+        {
+            return (pm_Words[fp_Bit >> 6].load(std::memory_order_relaxed) >> (fp_Bit & 63)) & 1;
+        }
+
+        [[nodiscard]] size_t
+            Size()
+            const
+        {
+            return pm_BitCount;
+        }
+
+    private:
+        std::vector<std::atomic<uint64_t>> pm_Words = {};
+        size_t pm_BitCount = 0;
+    };
+}
@@ -11,8 +11,14 @@
 
 #include <string>
 
+#include "BlockNodeKind.h"
+#include "SlotMap.h"
+#include "Parsers/BlockNodeEmitters.h"
+
 namespace Princess {
 
+	using BlockNodeHandle = SlotHandle; //index + generation into the ExecutionParser's slot map, stays detectably stale once the node is removed
+
 	//////////////////////////////////////////////
 	// Base Block Node Struct
 	//////////////////////////////////////////////
@@ -22,45 +28,72 @@ namespace Princess {
 	public:
 		std::string m_Name;
 		std::string m_CodeSnippet;
-		int m_LineNumber = -1;
+		int m_LineNumber = -1; //1-based first line in the last generated script, only kept up to date on flagged roots, nested nodes go through ExecutionParser::FindBlockNodeAtScriptLine()
 		unsigned int m_InputLineNumber; //will start at lineNumber 0 originating from the "Program Enter" node, dictates order
-		const unsigned int m_ID;
-		int m_ParentID = -1; //initialize to -1 to indicate no parent , id's are strictly positive
-		bool m_IsRootExecutable = false;
+		const BlockNodeHandle m_ID;
+		BlockNodeHandle m_ParentID = {}; //null handle indicates no parent
+		bool m_IsRootExecutable = false; //set through ExecutionParser::FlagBlockNodeForRootLevelExecution() so the execution order stays in sync
+		const BlockNodeKind m_Kind;
+
+		std::vector<BlockNode*> m_Children; //non-owning, every node is owned by the BlockNodeArena of its graph
+		std::vector<BlockNodeHandle> m_ChildIDs; //m_Children[i]'s handle, kept in step by ExecutionParser so a removed child can be told apart without reading through its pointer
+
+		//incremental codegen bookkeeping, only ExecutionParser should touch these
+		bool m_IsScriptDirty = true; //if a node is dirty so are all of its ancestors
+		unsigned int m_CachedScriptDepth = 0;
+		unsigned int m_CachedLineCount = 0; //lines emitted by this node and its whole subtree
+		unsigned int m_CachedSubtreeNodeCount = 0; //source map entries of this node and its whole subtree
+		unsigned int m_CachedSourceMapOffset = 0; //index of this node's source map entry relative to its parent's entry
+		size_t m_CachedScriptOffset = 0; //start of this subtree's text relative to the start of its parent's text
+		size_t m_CachedScriptLength = 0;
+		std::string m_CachedScript; //only filled on top level nodes codegen gets kicked off from, every descendant just indexes into it
 
-		std::vector<std::unique_ptr<BlockNode>> m_Children;
+		//structural hash over m_Kind, m_Name, m_CodeSnippet and the children's hashes in order, handles and placement don't count
+		uint64_t m_SubtreeHash = 0;
+		bool m_IsSubtreeHashDirty = true; //same rule as m_IsScriptDirty, but moving a branch leaves its own hash alone
+
+		//flattened snapshot bookkeeping, see ExecutionParser::CompileBlockNodeTree()
+		uint64_t m_SnapshotDirtyEpoch = 0; //same rule again, but only counts as dirty while it matches ExecutionParser's snapshot epoch, so building a snapshot clears every node at once
+		uint64_t m_SnapshotRevision = 0; //only read on top level nodes, restamped with the graph revision when anything below them changes
 
 	public:
-		BlockNode(const std::string& fp_Name, const std::string& fp_CodeSnippet, const unsigned int fp_ID)
-			: m_Name(fp_Name), m_CodeSnippet(fp_CodeSnippet), m_ID(fp_ID) {}
+		static constexpr BlockNodeKind KIND = BlockNodeKind::Statement;
+
+		BlockNode(const std::string& fp_Name, const std::string& fp_CodeSnippet, const BlockNodeHandle fp_ID)
+			: m_Name(fp_Name), m_CodeSnippet(fp_CodeSnippet), m_ID(fp_ID), m_Kind(KIND) {}
 
-		BlockNode(const std::string& fp_Name, const unsigned int fp_ID)
-			: m_Name(fp_Name), m_ID(fp_ID) {}
+		BlockNode(const std::string& fp_Name, const BlockNodeHandle fp_ID)
+			: m_Name(fp_Name), m_ID(fp_ID), m_Kind(KIND) {}
 
-		BlockNode(const unsigned int fp_ID)
-			: m_ID(fp_ID) {}
+		BlockNode(const BlockNodeHandle fp_ID)
+			: m_ID(fp_ID), m_Kind(KIND) {}
 
 		virtual ~BlockNode() = default;
 
+	protected:
+		BlockNode(const BlockNodeKind fp_Kind, const BlockNodeHandle fp_ID)
+			: m_ID(fp_ID), m_Kind(fp_Kind) {}
+
 	public:
-		virtual std::string ToScript(unsigned int depth = 0) const{
-			std::string indent(depth * 4, ' '); // 4 spaces per indent level
-			return indent + m_CodeSnippet + "\n";
+		std::string ToScript(unsigned int depth = 0) const{ //compatibility wrapper, codegen should emit into a shared ScriptSink instead
+			ScriptSink f_Sink;
+			EmitScript(f_Sink, depth);
+			return f_Sink.TakeScript();
+		}
+
+		void EmitScript(ScriptSink& fp_Sink, unsigned int depth = 0) const{ //no virtual call, m_Kind picks the emitter at compile time
+			EmitBlockNode(m_Kind, fp_Sink, m_Name, m_CodeSnippet, depth);
 		}
 	};
 
 	struct VariableDefinitionBlockNode : public BlockNode
 	{
-		VariableDefinitionBlockNode(const std::string& fp_Name, const unsigned int fp_ID) : BlockNode(fp_ID)
+		static constexpr BlockNodeKind KIND = BlockNodeKind::VariableDefinition;
+
+		VariableDefinitionBlockNode(const std::string& fp_Name, const BlockNodeHandle fp_ID) : BlockNode(KIND, fp_ID)
 		{
 			m_Name = fp_Name;
 		}
-
-	public:
-		std::string ToScript(unsigned int depth = 0) const override {
-			std::string indent(depth * 4, ' '); // 4 spaces per indent level
-			return indent + m_Name + " = " + m_CodeSnippet;
-		}
 	};
 
 	//////////////////////////////////////////////
@@ -69,33 +102,25 @@ namespace Princess {
 
 	struct FunctionDefinitionBlockNode : public BlockNode
 	{
+		static constexpr BlockNodeKind KIND = BlockNodeKind::FunctionDefinition;
+
 	public:
-		FunctionDefinitionBlockNode(const unsigned int fp_ID) : BlockNode(fp_ID)
+		FunctionDefinitionBlockNode(const BlockNodeHandle fp_ID) : BlockNode(KIND, fp_ID)
 		{
 
 		}
-
-	public:
-		std::string ToScript(unsigned int depth = 0) const override {
-			std::string indent(depth * 4, ' '); // 4 spaces per indent level
-			return indent + "def " + m_Name + ":" + "\n";
-		}
 	};
 
 	struct FunctionBlockNode : public BlockNode
 	{
+		static constexpr BlockNodeKind KIND = BlockNodeKind::Function;
+
 	public:
-		FunctionBlockNode(const std::string& fp_Name, const unsigned int fp_ID) : BlockNode(fp_ID)
+		FunctionBlockNode(const std::string& fp_Name, const BlockNodeHandle fp_ID) : BlockNode(KIND, fp_ID)
 		{
 			m_Name = fp_Name; //name actually matters here hehehe xd
 		}
 
-	public:
-		std::string ToScript(unsigned int depth = 0) const override {
-			std::string indent(depth * 4, ' '); // 4 spaces per indent level
-			return indent + "def " + m_Name + ":" + "\n";
-		}
-
 	public:
 		std::vector<std::string> m_ListOfArgs = {};
 	};
@@ -106,31 +131,23 @@ namespace Princess {
 
 	struct DictionaryBlockNode : public BlockNode
 	{
+		static constexpr BlockNodeKind KIND = BlockNodeKind::Dictionary;
+
 	public:
-		DictionaryBlockNode(const std::string& fp_Name, const unsigned int fp_ID) : BlockNode(fp_ID)
+		DictionaryBlockNode(const std::string& fp_Name, const BlockNodeHandle fp_ID) : BlockNode(KIND, fp_ID)
 		{
 			m_Name = fp_Name;
 		}
-
-	public:
-		std::string ToScript(unsigned int depth = 0) const override {
-			std::string indent(depth * 4, ' '); // 4 spaces per indent level
-			return indent + m_Name + " = " + m_CodeSnippet;
-		}
 	};
 
 	struct ListBlockNode : public BlockNode
 	{
-		ListBlockNode(const std::string& fp_Name, const unsigned int fp_ID) : BlockNode(fp_ID)
+		static constexpr BlockNodeKind KIND = BlockNodeKind::List;
+
+		ListBlockNode(const std::string& fp_Name, const BlockNodeHandle fp_ID) : BlockNode(KIND, fp_ID)
 		{
 			m_Name = fp_Name;
 		}
-
-	public:
-		std::string ToScript(unsigned int depth = 0) const override {
-			std::string indent(depth * 4, ' '); // 4 spaces per indent level
-			return indent + m_Name + " = " + m_CodeSnippet;
-		}
 	};
 
 	//////////////////////////////////////////////
@@ -139,62 +156,47 @@ namespace Princess {
 
 	struct WhileLoopBlockNode : public BlockNode
 	{
+		static constexpr BlockNodeKind KIND = BlockNodeKind::WhileLoop;
+
 	public:
-		WhileLoopBlockNode(const std::string& fp_Name, const std::string& fp_CodeSnippet, const unsigned int fp_ID) : BlockNode(fp_ID)
+		WhileLoopBlockNode(const std::string& fp_Name, const std::string& fp_CodeSnippet, const BlockNodeHandle fp_ID) : BlockNode(KIND, fp_ID)
 		{
 			m_Name = "while";
 		}
-
-	public:
-		std::string ToScript(unsigned int depth = 0) const override {
-			std::string indent(depth * 4, ' '); // 4 spaces per indent level
-			return indent + "while " + m_CodeSnippet + ":" + "\n";
-		}
 	};
 
 	struct ForLoopBlockNode : public BlockNode
 	{
+		static constexpr BlockNodeKind KIND = BlockNodeKind::ForLoop;
+
 	public:
-		ForLoopBlockNode(const unsigned int fp_ID) : BlockNode(fp_ID)
+		ForLoopBlockNode(const BlockNodeHandle fp_ID) : BlockNode(KIND, fp_ID)
 		{
 			m_Name = "for";
 		}
-
-	public:
-		std::string ToScript(unsigned int depth = 0) const override {
-			std::string indent(depth * 4, ' '); // 4 spaces per indent level
-			return indent + "for " + m_CodeSnippet + ":" + "\n";
-		}
 	};
 
 	struct ForEachBlockNode : public BlockNode
 	{
+		static constexpr BlockNodeKind KIND = BlockNodeKind::ForEach;
+
 	public:
-		ForEachBlockNode(const std::string& fp_CodeSnippet, const unsigned int fp_ID) : BlockNode(fp_ID)
+		ForEachBlockNode(const std::string& fp_CodeSnippet, const BlockNodeHandle fp_ID) : BlockNode(KIND, fp_ID)
 		{
 			m_Name = "for";
 		}
-
-	public:
-		std::string ToScript(unsigned int depth = 0) const override {
-			std::string indent(depth * 4, ' '); // 4 spaces per indent level
-			return indent + "foreach " + m_CodeSnippet + ":" + "\n";
-		}
 	};
 
 	struct BreakBlockNode : public BlockNode
 	{
+		static constexpr BlockNodeKind KIND = BlockNodeKind::Break;
+
 	public:
-		BreakBlockNode(const unsigned int fp_ID) : BlockNode(fp_ID)
+		BreakBlockNode(const BlockNodeHandle fp_ID) : BlockNode(KIND, fp_ID)
 		{
 			m_Name = "break";
 			m_CodeSnippet = "break";
 		}
-
-		std::string ToScript(unsigned int depth = 0) const override {
-			std::string indent(depth * 4, ' '); // 4 spaces per indent level
-			return indent + "break" + "\n";
-		}
 	};
 
 	//////////////////////////////////////////////
@@ -203,48 +205,37 @@ namespace Princess {
 
 	struct IfBlockNode : public BlockNode
 	{
+		static constexpr BlockNodeKind KIND = BlockNodeKind::If;
+
 	public:
-		IfBlockNode(const std::string& fp_CodeSnippet, const unsigned int fp_ID) : BlockNode(fp_ID)
+		IfBlockNode(const std::string& fp_CodeSnippet, const BlockNodeHandle fp_ID) : BlockNode(KIND, fp_ID)
 		{
 			m_Name = "if";
 		}
-
-	public:
-		std::string ToScript(unsigned int depth = 0) const override {
-			std::string indent(depth * 4, ' '); // 4 spaces per indent level
-			return indent + "if " + m_CodeSnippet + ":" + "\n";
-		}
 	};
 
 	struct ElseIfBlockNode : public BlockNode
 	{
+		static constexpr BlockNodeKind KIND = BlockNodeKind::ElseIf;
+
 	public:
-		ElseIfBlockNode(const std::string& fp_CodeSnippet, const unsigned int fp_ID)
-			: BlockNode(fp_ID)
+		ElseIfBlockNode(const std::string& fp_CodeSnippet, const BlockNodeHandle fp_ID)
+			: BlockNode(KIND, fp_ID)
 		{
 			m_Name = "elif";
 		}
 
-	public:
-		std::string ToScript(unsigned int depth = 0) const override {
-			std::string indent(depth * 4, ' '); // 4 spaces per indent level
-			return indent + "elif " + m_CodeSnippet + ":" + "\n";
-		}
-
 	};
 
 	struct ElseBlockNode : public BlockNode
 	{
+		static constexpr BlockNodeKind KIND = BlockNodeKind::Else;
+
 	public:
-		ElseBlockNode(const std::string& fp_CodeSnippet, const unsigned int fp_ID) : BlockNode(fp_ID)
+		ElseBlockNode(const std::string& fp_CodeSnippet, const BlockNodeHandle fp_ID) : BlockNode(KIND, fp_ID)
 		{
 			m_Name = "else";
 		}
-
-		std::string ToScript(unsigned int depth = 0) const override {
-			std::string indent(depth * 4, ' '); // 4 spaces per indent level
-			return indent + "else: " + "\n";
-		}
 	};
 }
 
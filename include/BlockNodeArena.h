@@ -0,0 +1,222 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <tuple>
+#include <utility>
+
+#include "BlockNode.h"
+
+namespace Princess {
+
+    //////////////////////////////////////////////
+    // Typed Slab Pool
+    //////////////////////////////////////////////
+    /*
+    Hands out fixed-size slots for a single BlockNode type. Slots are bump allocated out of large chunks so nodes created together
+    (eg. the children of one block while a project is loading) end up next to each other in memory, destroyed slots get recycled
+    through a free list, and Clear() releases every chunk at once instead of doing one free() per node.
+    */
+
+    template<typename T, size_t CHUNK_CAPACITY = 1024>
+    class BlockNodePool
+    {
+    public:
+        using ValueType = T;
+
+    public:
+        BlockNodePool() = default;
+
+        ~BlockNodePool()
+        {
+            Clear();
+        }
+
+        BlockNodePool(const BlockNodePool&) = delete;
+        BlockNodePool& operator=(const BlockNodePool&) = delete;
+
+    public:
+        template<typename... Args>
+        [[nodiscard]] T*
+            Create(Args&&... fp_Args)
+        {
+            T* f_Slot = nullptr;
+
+            if (not pm_FreeSlots.empty())
+            {
+                f_Slot = pm_FreeSlots.back();
+                pm_FreeSlots.pop_back();
+            }
+            else
+            {
+                if (pm_NextSlotInChunk == CHUNK_CAPACITY)
+                {
+                    pm_Chunks.emplace_back(new Slot[CHUNK_CAPACITY]); //default-init, we don't want the chunk zeroed since every slot gets constructed into anyways
+                    pm_NextSlotInChunk = 0;
+                }
+
+                f_Slot = reinterpret_cast<T*>(&pm_Chunks.back()[pm_NextSlotInChunk++]);
+            }
+
+            ++pm_LiveCount;
+            return ::new (static_cast<void*>(f_Slot)) T(std::forward<Args>(fp_Args)...);
+        }
+
+        void
+            Destroy(T* fp_Node)
+        {
+            if (not fp_Node)
+            {
+                return;
+            }
+
+            fp_Node->~T();
+            pm_FreeSlots.push_back(fp_Node);
+            --pm_LiveCount;
+        }
+
+        void
+            Clear() //destroys every live node and hands all chunks back in one go
+        {
+            if (pm_LiveCount > 0)
+            {
+                std::sort(pm_FreeSlots.begin(), pm_FreeSlots.end(), std::less<T*>()); //sorted so we can skip freed slots with a binary search instead of tracking liveness per slot
+
+                for (size_t l_Chunk = 0; l_Chunk < pm_Chunks.size(); l_Chunk++)
+                {
+                    const size_t f_UsedSlots = (l_Chunk + 1 == pm_Chunks.size()) ? pm_NextSlotInChunk : CHUNK_CAPACITY;
+
+                    for (size_t l_Slot = 0; l_Slot < f_UsedSlots; l_Slot++)
+                    {
+                        T* f_Node = reinterpret_cast<T*>(&pm_Chunks[l_Chunk][l_Slot]);
+
+                        if (not std::binary_search(pm_FreeSlots.begin(), pm_FreeSlots.end(), f_Node, std::less<T*>()))
+                        {
+                            f_Node->~T();
+                        }
+                    }
+                }
+            }
+
+            pm_Chunks.clear();
+            pm_FreeSlots.clear();
+            pm_NextSlotInChunk = CHUNK_CAPACITY;
+            pm_LiveCount = 0;
+        }
+
+        [[nodiscard]] size_t
+            GetLiveCount()
+            const
+        {
+            return pm_LiveCount;
+        }
+
+    private:
+        struct alignas(T) Slot
+        {
+            std::byte m_Bytes[sizeof(T)];
+        };
+
+        std::vector<std::unique_ptr<Slot[]>> pm_Chunks = {};
+        std::vector<T*> pm_FreeSlots = {};
+
+        size_t pm_NextSlotInChunk = CHUNK_CAPACITY; //starts "full" so the first Create() allocates a chunk
+        size_t pm_LiveCount = 0;
+    };
+
+    //////////////////////////////////////////////
+    // Per-Graph Block Node Arena
+    //////////////////////////////////////////////
+
+    class BlockNodeArena
+    {
+    public:
+        BlockNodeArena() = default;
+        ~BlockNodeArena() = default;
+
+        BlockNodeArena(const BlockNodeArena&) = delete;
+        BlockNodeArena& operator=(const BlockNodeArena&) = delete;
+
+    public:
+        template<typename T, typename... Args>
+        [[nodiscard]] T*
+            Create(Args&&... fp_Args)
+        {
+            return std::get<BlockNodePool<T>>(pm_Pools).Create(std::forward<Args>(fp_Args)...);
+        }
+
+        void
+            Destroy(BlockNode* fp_Node) //routes the node back to the pool of its concrete type using m_Kind
+        {
+            if (not fp_Node)
+            {
+                return;
+            }
+
+            std::apply
+            (
+                [fp_Node](auto&... fp_Pools)
+                {
+                    ([&]
+                    {
+                        using NodeType = typename std::decay_t<decltype(fp_Pools)>::ValueType;
+
+                        if (fp_Node->m_Kind != NodeType::KIND)
+                        {
+                            return false;
+                        }
+
+                        fp_Pools.Destroy(static_cast<NodeType*>(fp_Node));
+                        return true;
+                    }() or ...);
+                },
+                pm_Pools
+            );
+        }
+
+        void
+            Clear() //bulk free for closing a graph
+        {
+            std::apply([](auto&... fp_Pools) { (fp_Pools.Clear(), ...); }, pm_Pools);
+        }
+
+        [[nodiscard]] size_t
+            GetLiveBlockNodeCount()
+            const
+        {
+            return std::apply([](const auto&... fp_Pools) { return (fp_Pools.GetLiveCount() + ...); }, pm_Pools);
+        }
+
+    private:
+        std::tuple
+        <
+            BlockNodePool<BlockNode>,
+            BlockNodePool<VariableDefinitionBlockNode>,
+            BlockNodePool<FunctionDefinitionBlockNode>,
+            BlockNodePool<FunctionBlockNode>,
+            BlockNodePool<DictionaryBlockNode>,
+            BlockNodePool<ListBlockNode>,
+            BlockNodePool<WhileLoopBlockNode>,
+            BlockNodePool<ForLoopBlockNode>,
+            BlockNodePool<ForEachBlockNode>,
+            BlockNodePool<BreakBlockNode>,
+            BlockNodePool<IfBlockNode>,
+            BlockNodePool<ElseIfBlockNode>,
+            BlockNodePool<ElseBlockNode>
+        > pm_Pools;
+
+        static_assert(std::tuple_size_v<decltype(pm_Pools)> == static_cast<size_t>(BlockNodeKind::COUNT), "Every BlockNodeKind needs a pool inside BlockNodeArena");
+    };
+}
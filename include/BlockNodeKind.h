@@ -0,0 +1,60 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace Princess {
+
+    //////////////////////////////////////////////
+    // Block Node Kinds
+    //////////////////////////////////////////////
+
+    enum class BlockNodeKind : unsigned char //one per BlockNode struct, the arena routes nodes back to their typed pool with it and codegen picks an emitter with it, no RTTI or virtual calls needed
+    {
+        Statement,
+        VariableDefinition,
+        FunctionDefinition,
+        Function,
+        Dictionary,
+        List,
+        WhileLoop,
+        ForLoop,
+        ForEach,
+        Break,
+        If,
+        ElseIf,
+        Else,
+
+        COUNT
+    };
+
+    inline constexpr size_t BLOCK_NODE_KIND_COUNT = static_cast<size_t>(BlockNodeKind::COUNT);
+
+    inline constexpr std::array<std::string_view, BLOCK_NODE_KIND_COUNT> BLOCK_NODE_KIND_NAMES = //same order as the enum, used wherever kinds get spelled out in text (eg. ConfigScriptBackend)
+    {
+        "statement",
+        "variable_definition",
+        "function_definition",
+        "function",
+        "dictionary",
+        "list",
+        "while_loop",
+        "for_loop",
+        "for_each",
+        "break",
+        "if",
+        "else_if",
+        "else"
+    };
+}
@@ -0,0 +1,227 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "BlockNode.h"
+
+namespace Princess {
+
+    //////////////////////////////////////////////
+    // Block Node Visit
+    //////////////////////////////////////////////
+
+    enum class BlockNodeVisit : unsigned char
+    {
+        Continue, //walk into the children, then call the post order hook
+        SkipChildren, //the node is done, neither its children nor its post order hook get visited
+        Stop //ends the whole walk right away, nothing else gets visited
+    };
+
+    struct NoBlockNodeVisitor //default post order hook, compiles away
+    {
+        void operator()(const BlockNode*, const unsigned int) const {}
+    };
+
+    //////////////////////////////////////////////
+    // Block Node Traversal
+    //////////////////////////////////////////////
+    /*
+    Depth first walk over m_Children with an explicit stack, so a chain of nested blocks is only limited by memory and not by the call
+    stack. Hooks get (node, depth) with the starting node at depth 0 and return a BlockNodeVisit, hooks returning void always continue.
+    The stack is kept between walks, so reusing one traversal stops allocating once it has seen the deepest tree. One walk at a time per
+    traversal though, a hook that starts another walk needs a traversal of its own.
+    A hook may edit the node it's handed, and the post order hook may even destroy it, the walk never looks at a node again after its
+    post order hook. m_Children of nodes still on the stack must not change while the walk is below them.
+    */
+
+    class BlockNodeTraversal
+    {
+    public:
+        template<typename NODE, typename PRE_VISITOR, typename POST_VISITOR = NoBlockNodeVisitor>
+        bool
+            Walk(NODE* fp_Root, PRE_VISITOR&& fp_PreOrder, POST_VISITOR&& fp_PostOrder = {}) //false if a hook stopped the walk early
+        {
+            static_assert(std::is_base_of_v<BlockNode, std::remove_const_t<NODE>>, "Walk() needs a BlockNode or a const BlockNode");
+
+            if (not fp_Root)
+            {
+                return true;
+            }
+
+            bool f_IsFinished = false;
+
+            if constexpr (std::is_same_v<std::remove_cvref_t<POST_VISITOR>, NoBlockNodeVisitor>)
+            {
+                std::vector<Pending> f_Stack = std::move(pm_PendingStack); //a local the hooks can't alias, so its ends don't get reloaded after every hook
+                f_IsFinished = WalkPreOrder<NODE>(fp_Root, fp_PreOrder, f_Stack);
+                pm_PendingStack = std::move(f_Stack);
+            }
+            else
+            {
+                std::vector<Frame> f_Stack = std::move(pm_FrameStack);
+                f_IsFinished = WalkPrePostOrder<NODE>(fp_Root, fp_PreOrder, fp_PostOrder, f_Stack);
+                pm_FrameStack = std::move(f_Stack);
+            }
+
+            return f_IsFinished;
+        }
+
+        template<typename NODE, typename PREDICATE>
+        NODE*
+            Find(NODE* fp_Root, PREDICATE&& fp_Predicate) //first node in preorder fp_Predicate(node) holds for, nullptr if there is none
+        {
+            NODE* f_Found = nullptr;
+
+            Walk
+            (
+                fp_Root,
+                [&f_Found, &fp_Predicate](NODE* fp_BlockNode, const unsigned int)
+                {
+                    if (not fp_Predicate(fp_BlockNode)) { return BlockNodeVisit::Continue; }
+
+                    f_Found = fp_BlockNode;
+                    return BlockNodeVisit::Stop;
+                }
+            );
+
+            return f_Found;
+        }
+
+    private:
+        struct Pending //a node waiting for its pre order hook
+        {
+            const BlockNode* m_BlockNode;
+            unsigned int m_Depth;
+        };
+
+        struct Frame //a node whose children are being walked
+        {
+            const BlockNode* m_BlockNode;
+            unsigned int m_Depth;
+            uint32_t m_NextChild; //index into m_BlockNode->m_Children of the next child to visit
+        };
+
+        template<typename VISITOR, typename NODE>
+        static BlockNodeVisit
+            Visit(VISITOR& fp_Visitor, NODE* fp_BlockNode, const unsigned int fp_Depth)
+        {
+            if constexpr (std::is_void_v<std::invoke_result_t<VISITOR&, NODE*, const unsigned int>>)
+            {
+                fp_Visitor(fp_BlockNode, fp_Depth);
+                return BlockNodeVisit::Continue;
+            }
+            else
+            {
+                return fp_Visitor(fp_BlockNode, fp_Depth);
+            }
+        }
+
+        //Without a post order hook nothing has to be remembered about a node once it's visited, so its children just get queued up
+        template<typename NODE, typename PRE_VISITOR>
+        static bool
+            WalkPreOrder(NODE* fp_Root, PRE_VISITOR& fp_PreOrder, std::vector<Pending>& fp_Stack)
+        {
+            fp_Stack.clear();
+            fp_Stack.push_back({ fp_Root, 0 });
+
+            while (not fp_Stack.empty())
+            {
+                NODE* f_BlockNode = const_cast<NODE*>(fp_Stack.back().m_BlockNode); //only ever holds nodes that came in as NODE*
+                const unsigned int f_Depth = fp_Stack.back().m_Depth;
+                fp_Stack.pop_back();
+
+                const BlockNodeVisit f_Visit = Visit(fp_PreOrder, f_BlockNode, f_Depth);
+
+                if (f_Visit == BlockNodeVisit::Stop)
+                {
+                    fp_Stack.clear();
+                    return false;
+                }
+
+                if (f_Visit == BlockNodeVisit::Continue)
+                {
+                    for (auto l_Child = f_BlockNode->m_Children.rbegin(); l_Child != f_BlockNode->m_Children.rend(); ++l_Child) //reversed so the first child comes off the stack first
+                    {
+                        fp_Stack.push_back({ *l_Child, f_Depth + 1 });
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        template<typename NODE, typename PRE_VISITOR, typename POST_VISITOR>
+        static bool
+            WalkPrePostOrder(NODE* fp_Root, PRE_VISITOR& fp_PreOrder, POST_VISITOR& fp_PostOrder, std::vector<Frame>& fp_Stack)
+        {
+            fp_Stack.clear();
+
+            switch (Visit(fp_PreOrder, fp_Root, 0))
+            {
+            case BlockNodeVisit::Stop: return false;
+            case BlockNodeVisit::SkipChildren: return true;
+            case BlockNodeVisit::Continue: break;
+            }
+
+            fp_Stack.push_back({ fp_Root, 0, 0 });
+
+            while (not fp_Stack.empty())
+            {
+                Frame& f_Frame = fp_Stack.back();
+
+                if (f_Frame.m_NextChild < f_Frame.m_BlockNode->m_Children.size())
+                {
+                    NODE* f_Child = f_Frame.m_BlockNode->m_Children[f_Frame.m_NextChild++];
+                    const unsigned int f_Depth = f_Frame.m_Depth + 1;
+
+                    BlockNodeVisit f_Visit = Visit(fp_PreOrder, f_Child, f_Depth);
+
+                    if (f_Visit == BlockNodeVisit::Continue and f_Child->m_Children.empty()) //leaves go straight to their post order hook, no frame needed
+                    {
+                        f_Visit = Visit(fp_PostOrder, f_Child, f_Depth);
+                    }
+                    else if (f_Visit == BlockNodeVisit::Continue)
+                    {
+                        fp_Stack.push_back({ f_Child, f_Depth, 0 }); //invalidates f_Frame, it isn't used again this iteration
+                    }
+
+                    if (f_Visit == BlockNodeVisit::Stop)
+                    {
+                        fp_Stack.clear();
+                        return false;
+                    }
+
+                    continue;
+                }
+
+                NODE* f_BlockNode = const_cast<NODE*>(f_Frame.m_BlockNode);
+                const unsigned int f_Depth = f_Frame.m_Depth;
+                fp_Stack.pop_back();
+
+                if (Visit(fp_PostOrder, f_BlockNode, f_Depth) == BlockNodeVisit::Stop)
+                {
+                    fp_Stack.clear();
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+    private:
+        std::vector<Pending> pm_PendingStack = {};
+        std::vector<Frame> pm_FrameStack = {};
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "RenderingManager.h"
+#include "Parsers/PythonScriptParser.h"
 #include <atomic>
 
 
@@ -81,6 +82,12 @@ namespace Princess{
                 return false;
             }
             
+            if (not PythonScriptParser::Parser().InitializeInterpreter(fp_RootPath + "/logs", "script_cache")) //stays alive for the whole session so rerunning a graph never pays interpreter startup again, and compiled scripts outlive it on disk
+            {
+                editor_logger->LogAndPrint("Failed to start the embedded Python interpreter, ending engine program execution immediately", "EditorManager", Logger::LogLevel::Fatal);
+                return false;
+            }
+
             if (not SDL_Init(SDL_INIT_VIDEO))
             {
                 editor_logger->LogAndPrint(format("SDL could not initialize! ending engine program execution immediately, SDL_Error: {}", string(SDL_GetError())), "EditorManager", Logger::LogLevel::Fatal);
@@ -142,6 +149,7 @@ namespace Princess{
         {
             //CLEAN-UP AND ANY CLOSING THINGS THAT SHOULD BE LOGGED TO CHECK THE STATE OF THE ENGINE AS IT EXITS
             // PeachCore::PluginManager::ManagePlugins().ShutdownPlugins();
+            PythonScriptParser::Parser().ShutdownInterpreter();
             SDL_Quit(); //just makes more sense to have the ShutdownPeachEngine method to do this
 
             return true;
@@ -228,7 +236,39 @@ namespace Princess{
         void
             UpdateEditorState()
         {
-            
+            PollScriptEvents();
+        }
+
+        void
+            PollScriptEvents() //drains what the script thread produced since the last tick, never waits on the script so rendering keeps its pace
+        {
+            PythonScriptParser::Parser().PollScriptEvents
+            (
+                [this](ScriptEvent& fp_Event)
+                {
+                    switch (fp_Event.m_Type)
+                    {
+                        case ScriptEvent::Type::Output:
+                            editor_logger->LogAndPrint(fp_Event.m_Text, format("Script {}", fp_Event.m_RunID), Logger::LogLevel::Info);
+                            break;
+                        case ScriptEvent::Type::ErrorOutput:
+                            editor_logger->LogAndPrint(fp_Event.m_Text, format("Script {}", fp_Event.m_RunID), Logger::LogLevel::Warning);
+                            break;
+                        case ScriptEvent::Type::Finished:
+                            editor_logger->LogAndPrint("Script finished" + fp_Event.m_Text, format("Script {}", fp_Event.m_RunID), Logger::LogLevel::Debug);
+                            break;
+                        case ScriptEvent::Type::Failed:
+                            editor_logger->LogAndPrint("Script failed: " + fp_Event.m_Text, format("Script {}", fp_Event.m_RunID), Logger::LogLevel::Error);
+                            break;
+                        case ScriptEvent::Type::Cancelled:
+                            editor_logger->LogAndPrint("Script cancelled" + fp_Event.m_Text, format("Script {}", fp_Event.m_RunID), Logger::LogLevel::Warning);
+                            break;
+                        case ScriptEvent::Type::TimedOut:
+                            editor_logger->LogAndPrint("Script timed out" + fp_Event.m_Text, format("Script {}", fp_Event.m_RunID), Logger::LogLevel::Warning);
+                            break;
+                    }
+                }
+            );
         }
 
         //////////////////////////////////////////////
@@ -0,0 +1,396 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Logger.h"
+
+namespace Princess {
+
+    //////////////////////////////////////////////
+    // JSON Token and Token-type Definition
+    //////////////////////////////////////////////
+
+    enum class JSONTokenType
+    {
+        //////////////////// GOATS ////////////////////
+
+        IntLiteral,
+        FloatLiteral,
+        StringLiteral,
+        NullLiteral,
+        BoolLiteral,
+
+        //////////////////// Bracket Types ////////////////////
+
+        OpenBracket,
+        CloseBracket,
+
+        OpenSquareBracket,
+        CloseSquareBracket,
+
+        //////////////////// Symbols ////////////////////
+
+        DoubleDot, // ':'
+        Comma,
+
+        //////////////////// End Of File ////////////////////
+
+        ENDF
+    };
+
+    inline void
+        UnescapeJSONString(const string_view fp_Escaped, string& fp_Unescaped) //appends fp_Escaped to fp_Unescaped with its escape sequences resolved
+    {
+        size_t f_RunStart = 0;
+
+        for (size_t l_Backslash = fp_Escaped.find('\\'); l_Backslash != string_view::npos; l_Backslash = fp_Escaped.find('\\', f_RunStart))
+        {
+            fp_Unescaped.append(fp_Escaped.substr(f_RunStart, l_Backslash - f_RunStart));
+
+            const char f_EscapedChar = l_Backslash + 1 < fp_Escaped.size() ? fp_Escaped[l_Backslash + 1] : '\0';
+
+            switch (f_EscapedChar)
+            {
+            case 'n': fp_Unescaped += '\n'; break;
+            case 't': fp_Unescaped += '\t'; break;
+            case '\\': fp_Unescaped += '\\'; break;
+            case '"': fp_Unescaped += '"'; break;
+            default: //unknown escape sequences are kept as they were written, backslash and all
+                fp_Unescaped += '\\';
+                fp_Unescaped += f_EscapedChar;
+                break;
+            }
+
+            f_RunStart = l_Backslash + 2;
+        }
+
+        if (f_RunStart < fp_Escaped.size())
+        {
+            fp_Unescaped.append(fp_Escaped.substr(f_RunStart));
+        }
+    }
+
+    struct JSONToken
+    {
+        string_view m_Value; //slice of the source, string literals come without their quotes and with their escapes still in
+        JSONTokenType m_Type = JSONTokenType::ENDF;
+        bool m_HasEscapes = false; //string literals only, m_Value needs unescaping before it can be used as text
+        int m_SourceCodeLineNumber = 0;
+
+        string
+            GetString() //the string literal's text, the escapes only get resolved here and only for strings that have any
+            const
+        {
+            if (not m_HasEscapes)
+            {
+                return string(m_Value);
+            }
+
+            string f_Unescaped;
+            f_Unescaped.reserve(m_Value.size());
+            UnescapeJSONString(m_Value, f_Unescaped);
+
+            return f_Unescaped;
+        }
+    };
+
+    //////////////////////////////////////////////
+    // JSON Lexer
+    //////////////////////////////////////////////
+    /*
+    Walks the source once with a cursor, nothing is ever erased from the front so lexing is linear in the size of the input. Tokens
+    are slices of the source and never allocate, so the source has to outlive every token lexed out of it. String literals keep
+    their escapes until someone asks for their text with GetString(). The first lexing error gets logged with its line number and
+    ends the lexer, every call after that returns ENDF.
+    */
+
+    class JSONLexer
+    {
+    public:
+        explicit JSONLexer(const string_view fp_Source, Logger* fp_Logger) : pm_Source(fp_Source), pm_Logger(fp_Logger) {}
+
+        bool
+            Next(JSONToken& fp_Token) //lexes one token into fp_Token, ENDF once the source runs out, false on a lexing error
+        {
+            SkipWhitespace();
+
+            if (IsAtEnd())
+            {
+                SetToken(fp_Token, string_view(), JSONTokenType::ENDF, pm_LineNumber); //label the end of the file i guess for some reason
+                return true;
+            }
+
+            const char f_CurrentChar = pm_Source[pm_Position];
+
+            if (IsDigit(f_CurrentChar) or f_CurrentChar == '-') //used for finding floats and ints defined inside the JSON
+            {
+                return LexNumber(fp_Token);
+            }
+            else if (IsAlpha(f_CurrentChar)) //used for finding bools and null literals inside the JSON
+            {
+                return LexIdentifier(fp_Token);
+            }
+
+            switch (f_CurrentChar)
+            {
+            case ':': return LexSymbol(fp_Token, JSONTokenType::DoubleDot);
+            case ',': return LexSymbol(fp_Token, JSONTokenType::Comma);
+
+            case '{': return LexSymbol(fp_Token, JSONTokenType::OpenBracket);
+            case '}': return LexSymbol(fp_Token, JSONTokenType::CloseBracket);
+
+            case '[': return LexSymbol(fp_Token, JSONTokenType::OpenSquareBracket);
+            case ']': return LexSymbol(fp_Token, JSONTokenType::CloseSquareBracket);
+
+            case '.': return LexLeadingDecimal(fp_Token);
+            case '"': return LexString(fp_Token);
+
+            default:
+                return Fail(format("Lexing Error: Unrecognized character found: [{}], found at line number: {}", f_CurrentChar, pm_LineNumber));
+            }
+        }
+
+        bool
+            Tokenize(vector<JSONToken>& fp_Tokens) //lexes the whole source, fp_Tokens ends on an ENDF token when it succeeds
+        {
+            do
+            {
+                fp_Tokens.emplace_back();
+
+                if (not Next(fp_Tokens.back()))
+                {
+                    fp_Tokens.pop_back();
+                    return false;
+                }
+            }
+            while (fp_Tokens.back().m_Type != JSONTokenType::ENDF);
+
+            return true;
+        }
+
+        size_t
+            GetLineNumber()
+            const
+        {
+            return pm_LineNumber;
+        }
+
+    private:
+        //////////////////////////////////////////////
+        // Cursor
+        //////////////////////////////////////////////
+
+        static bool IsDigit(const char fp_Char) { return fp_Char >= '0' and fp_Char <= '9'; } //not isdigit(), that one goes through the locale and is UB for negative chars
+        static bool IsAlpha(const char fp_Char) { return (fp_Char | 0x20) >= 'a' and (fp_Char | 0x20) <= 'z'; }
+
+        bool
+            IsAtEnd()
+            const
+        {
+            return pm_Position >= pm_Source.size();
+        }
+
+        char
+            Peek(const size_t fp_Offset = 0) //'\0' past the end, so lookahead never needs its own bounds check
+            const
+        {
+            return pm_Position + fp_Offset < pm_Source.size() ? pm_Source[pm_Position + fp_Offset] : '\0';
+        }
+
+        void
+            SkipDigits()
+        {
+            while (IsDigit(Peek()))
+            {
+                pm_Position++;
+            }
+        }
+
+        void
+            SkipWhitespace()
+        {
+            for (; not IsAtEnd(); pm_Position++)
+            {
+                switch (pm_Source[pm_Position])
+                {
+                case '\n': //used to keep track of what line number we're at in the source code
+                    pm_LineNumber++;
+                    break;
+                case ' ': case '\t': case '\r': case '\v': case '\f':
+                    break;
+                default:
+                    return;
+                }
+            }
+        }
+
+        static void
+            SetToken(JSONToken& fp_Token, const string_view fp_Value, const JSONTokenType fp_Type, const size_t fp_LineNumber, const bool fp_HasEscapes = false)
+        {
+            fp_Token.m_Value = fp_Value;
+            fp_Token.m_Type = fp_Type;
+            fp_Token.m_HasEscapes = fp_HasEscapes;
+            fp_Token.m_SourceCodeLineNumber = static_cast<int>(fp_LineNumber);
+        }
+
+        bool
+            Fail(const string& fp_Message)
+        {
+            pm_Logger->LogAndPrint(fp_Message, "Lexer", Logger::LogLevel::Error);
+            pm_Position = pm_Source.size(); //dump the rest of the source, so that nothing else gets processed
+            return false;
+        }
+
+        //////////////////////////////////////////////
+        // Token Lexing
+        //////////////////////////////////////////////
+
+        bool
+            LexSymbol(JSONToken& fp_Token, const JSONTokenType fp_Type)
+        {
+            SetToken(fp_Token, pm_Source.substr(pm_Position, 1), fp_Type, pm_LineNumber);
+            pm_Position++;
+            return true;
+        }
+
+        bool
+            LexNumber(JSONToken& fp_Token)
+        {
+            const size_t f_Start = pm_Position;
+
+            if (Peek() == '-')
+            {
+                pm_Position++;
+
+                if (not IsDigit(Peek()))
+                {
+                    return Fail(format("Unexpected symbol following character: '-', looks like you've input a non-numeric symbol: '{}' while defining a negative number at line number: {}", Peek(), pm_LineNumber));
+                }
+            }
+
+            SkipDigits();
+
+            JSONTokenType f_Type = JSONTokenType::IntLiteral;
+
+            if (Peek() == '.') //used for handling decimal numbers eg. "3.14"
+            {
+                if (not IsDigit(Peek(1)))
+                {
+                    return Fail(format("Unexpected symbol following a '.' brother!, looks like you've input a non-numeric symbol: '{}' while defining a decimal number at line number: {}", Peek(1), pm_LineNumber));
+                }
+
+                pm_Position++;
+                SkipDigits();
+                f_Type = JSONTokenType::FloatLiteral;
+            }
+
+            SetToken(fp_Token, pm_Source.substr(f_Start, pm_Position - f_Start), f_Type, pm_LineNumber);
+            return true;
+        }
+
+        bool
+            LexLeadingDecimal(JSONToken& fp_Token) //".5" is a float, from_chars() reads it as 0.5 later on
+        {
+            if (not IsDigit(Peek(1)))
+            {
+                return Fail(format("Lexing Error: Invalid JSON identifier: '{}', found at line number: {}", Peek(1), pm_LineNumber));
+            }
+
+            const size_t f_Start = pm_Position;
+            pm_Position++;
+            SkipDigits();
+
+            SetToken(fp_Token, pm_Source.substr(f_Start, pm_Position - f_Start), JSONTokenType::FloatLiteral, pm_LineNumber);
+            return true;
+        }
+
+        bool
+            LexIdentifier(JSONToken& fp_Token)
+        {
+            const size_t f_Start = pm_Position;
+
+            while (IsAlpha(Peek()))
+            {
+                pm_Position++;
+            }
+
+            const string_view f_Identifier = pm_Source.substr(f_Start, pm_Position - f_Start);
+
+            if (f_Identifier == "true" or f_Identifier == "false")
+            {
+                SetToken(fp_Token, f_Identifier, JSONTokenType::BoolLiteral, pm_LineNumber);
+            }
+            else if (f_Identifier == "null")
+            {
+                SetToken(fp_Token, f_Identifier, JSONTokenType::NullLiteral, pm_LineNumber);
+            }
+            else
+            {
+                return Fail(format("Lexing Error: Invalid JSON identifier: '{}', found at line number: {}", f_Identifier, pm_LineNumber));
+            }
+
+            return true;
+        }
+
+        //Only finds where the literal ends, escapes get skipped over here and resolved by GetString() if the text is ever needed
+        bool
+            LexString(JSONToken& fp_Token)
+        {
+            const size_t f_LineNumber = pm_LineNumber; //the token reports the line it starts on
+            const size_t f_Start = ++pm_Position; //skip the opening quote
+
+            bool f_HasEscapes = false;
+
+            while (not IsAtEnd())
+            {
+                const char f_CurrentChar = pm_Source[pm_Position];
+
+                if (f_CurrentChar == '"')
+                {
+                    SetToken(fp_Token, pm_Source.substr(f_Start, pm_Position - f_Start), JSONTokenType::StringLiteral, f_LineNumber, f_HasEscapes);
+                    pm_Position++; //skip the closing quote
+                    return true;
+                }
+                else if (f_CurrentChar == '\\')
+                {
+                    f_HasEscapes = true;
+
+                    if (Peek(1) == '\n')
+                    {
+                        pm_LineNumber++;
+                    }
+
+                    pm_Position += 2; //the escaped character can't end the literal, not even a quote
+                    continue;
+                }
+                else if (f_CurrentChar == '\n')
+                {
+                    pm_LineNumber++;
+                }
+
+                pm_Position++;
+            }
+
+            return Fail("Unterminated string literal, brother! Error occured at line number: " + to_string(f_LineNumber));
+        }
+
+    private:
+        string_view pm_Source;
+        size_t pm_Position = 0;
+        size_t pm_LineNumber = 1;
+
+        Logger* pm_Logger = nullptr;
+    };
+}
@@ -0,0 +1,234 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <array>
+#include <string_view>
+#include <utility>
+
+#include "../BlockNodeKind.h"
+#include "ScriptSink.h"
+
+namespace Princess {
+
+    //////////////////////////////////////////////
+    // Per-Kind Emitters
+    //////////////////////////////////////////////
+    /*
+    Every BlockNode kind only differs in the text wrapped around m_Name/m_CodeSnippet, so instead of a virtual ToScript() per struct each
+    (backend, kind) pair gets a specialization. The primary template is intentionally left undefined, forgetting to add an emitter for a
+    new kind fails to compile when that backend's BLOCK_NODE_EMITTER_TABLE gets built. The Python ones live here since Python is what
+    the editor actually runs, other target languages get their own header (LuaScriptBackend.h, ConfigScriptBackend.h).
+    */
+
+    template<typename BACKEND, BlockNodeKind KIND>
+    struct BlockNodeEmitter;
+
+    struct PythonScriptBackend;
+
+    template<>
+    struct BlockNodeEmitter<PythonScriptBackend, BlockNodeKind::Statement>
+    {
+        static void Emit(ScriptSink& fp_Sink, std::string_view /*fp_Name*/, std::string_view fp_CodeSnippet, unsigned int fp_Depth)
+        {
+            fp_Sink.Indent(fp_Depth).Append(fp_CodeSnippet).Append('\n');
+        }
+    };
+
+    template<>
+    struct BlockNodeEmitter<PythonScriptBackend, BlockNodeKind::VariableDefinition>
+    {
+        static void Emit(ScriptSink& fp_Sink, std::string_view fp_Name, std::string_view fp_CodeSnippet, unsigned int fp_Depth)
+        {
+            fp_Sink.Indent(fp_Depth).Append(fp_Name).Append(" = ").Append(fp_CodeSnippet);
+        }
+    };
+
+    template<>
+    struct BlockNodeEmitter<PythonScriptBackend, BlockNodeKind::FunctionDefinition>
+    {
+        static void Emit(ScriptSink& fp_Sink, std::string_view fp_Name, std::string_view /*fp_CodeSnippet*/, unsigned int fp_Depth)
+        {
+            fp_Sink.Indent(fp_Depth).Append("def ").Append(fp_Name).Append(":\n");
+        }
+    };
+
+    template<>
+    struct BlockNodeEmitter<PythonScriptBackend, BlockNodeKind::Function> : BlockNodeEmitter<PythonScriptBackend, BlockNodeKind::FunctionDefinition> {};
+
+    template<>
+    struct BlockNodeEmitter<PythonScriptBackend, BlockNodeKind::Dictionary> : BlockNodeEmitter<PythonScriptBackend, BlockNodeKind::VariableDefinition> {};
+
+    template<>
+    struct BlockNodeEmitter<PythonScriptBackend, BlockNodeKind::List> : BlockNodeEmitter<PythonScriptBackend, BlockNodeKind::VariableDefinition> {};
+
+    template<>
+    struct BlockNodeEmitter<PythonScriptBackend, BlockNodeKind::WhileLoop>
+    {
+        static void Emit(ScriptSink& fp_Sink, std::string_view /*fp_Name*/, std::string_view fp_CodeSnippet, unsigned int fp_Depth)
+        {
+            fp_Sink.Indent(fp_Depth).Append("while ").Append(fp_CodeSnippet).Append(":\n");
+        }
+    };
+
+    template<>
+    struct BlockNodeEmitter<PythonScriptBackend, BlockNodeKind::ForLoop>
+    {
+        static void Emit(ScriptSink& fp_Sink, std::string_view /*fp_Name*/, std::string_view fp_CodeSnippet, unsigned int fp_Depth)
+        {
+            fp_Sink.Indent(fp_Depth).Append("for ").Append(fp_CodeSnippet).Append(":\n");
+        }
+    };
+
+    template<>
+    struct BlockNodeEmitter<PythonScriptBackend, BlockNodeKind::ForEach>
+    {
+        static void Emit(ScriptSink& fp_Sink, std::string_view /*fp_Name*/, std::string_view fp_CodeSnippet, unsigned int fp_Depth)
+        {
+            fp_Sink.Indent(fp_Depth).Append("foreach ").Append(fp_CodeSnippet).Append(":\n");
+        }
+    };
+
+    template<>
+    struct BlockNodeEmitter<PythonScriptBackend, BlockNodeKind::Break>
+    {
+        static void Emit(ScriptSink& fp_Sink, std::string_view /*fp_Name*/, std::string_view /*fp_CodeSnippet*/, unsigned int fp_Depth)
+        {
+            fp_Sink.Indent(fp_Depth).Append("break\n");
+        }
+    };
+
+    template<>
+    struct BlockNodeEmitter<PythonScriptBackend, BlockNodeKind::If>
+    {
+        static void Emit(ScriptSink& fp_Sink, std::string_view /*fp_Name*/, std::string_view fp_CodeSnippet, unsigned int fp_Depth)
+        {
+            fp_Sink.Indent(fp_Depth).Append("if ").Append(fp_CodeSnippet).Append(":\n");
+        }
+    };
+
+    template<>
+    struct BlockNodeEmitter<PythonScriptBackend, BlockNodeKind::ElseIf>
+    {
+        static void Emit(ScriptSink& fp_Sink, std::string_view /*fp_Name*/, std::string_view fp_CodeSnippet, unsigned int fp_Depth)
+        {
+            fp_Sink.Indent(fp_Depth).Append("elif ").Append(fp_CodeSnippet).Append(":\n");
+        }
+    };
+
+    template<>
+    struct BlockNodeEmitter<PythonScriptBackend, BlockNodeKind::Else>
+    {
+        static void Emit(ScriptSink& fp_Sink, std::string_view /*fp_Name*/, std::string_view /*fp_CodeSnippet*/, unsigned int fp_Depth)
+        {
+            fp_Sink.Indent(fp_Depth).Append("else: \n");
+        }
+    };
+
+    //////////////////////////////////////////////
+    // Compile-Time Dispatch
+    //////////////////////////////////////////////
+
+    using BlockNodeEmitFunction = void(*)(ScriptSink&, std::string_view, std::string_view, unsigned int);
+
+    template<typename BACKEND, size_t... KIND_INDICES>
+    constexpr std::array<BlockNodeEmitFunction, sizeof...(KIND_INDICES)>
+        MakeBlockNodeEmitterTable(std::index_sequence<KIND_INDICES...>)
+    {
+        return { &BlockNodeEmitter<BACKEND, static_cast<BlockNodeKind>(KIND_INDICES)>::Emit... };
+    }
+
+    template<typename BACKEND>
+    inline constexpr auto BLOCK_NODE_EMITTER_TABLE = MakeBlockNodeEmitterTable<BACKEND>(std::make_index_sequence<BLOCK_NODE_KIND_COUNT>{}); //one entry per kind or this doesn't compile
+
+    template<typename BACKEND, size_t... KIND_INDICES>
+    inline void
+        DispatchBlockNodeEmitter
+        (
+            std::index_sequence<KIND_INDICES...>,
+            const BlockNodeKind fp_Kind,
+            ScriptSink& fp_Sink,
+            const std::string_view fp_Name,
+            const std::string_view fp_CodeSnippet,
+            const unsigned int fp_Depth
+        )
+    {
+        //expands into a chain of compares against constants that the compiler folds into a switch, each emitter stays inlinable
+        ((fp_Kind == static_cast<BlockNodeKind>(KIND_INDICES) 
+            ? (BlockNodeEmitter<BACKEND, static_cast<BlockNodeKind>(KIND_INDICES)>::Emit(fp_Sink, fp_Name, fp_CodeSnippet, fp_Depth), true) 
+            : false) or ...);
+    }
+
+    //////////////////////////////////////////////
+    // Script Backends
+    //////////////////////////////////////////////
+    /*
+    A backend is a policy the tree walk is templated on, so one walk can feed several target languages at once with everything inlined
+    and no virtual call per node. Each one provides:
+
+        HAS_BLOCK_TERMINATORS                            false lets the walk skip tracking open blocks entirely (Python)
+        EmitBlockOpen(kind, sink, name, snippet, depth)  the node's own text, written before its children
+        EmitBlockClose(kind, sink, depth)                written once the node's whole subtree is done, eg. Lua's "end"
+        ContinuesBlock(closing kind, next kind)          true when the next sibling carries on the closing node's block (if -> elseif/else),
+                                                         so nothing gets closed between them
+
+    Python and Lua are stateless, ConfigScriptBackend holds its templates at runtime.
+    */
+
+    struct PythonScriptBackend
+    {
+        static constexpr bool HAS_BLOCK_TERMINATORS = false;
+
+        void
+            EmitBlockOpen(const BlockNodeKind fp_Kind, ScriptSink& fp_Sink, const std::string_view fp_Name, const std::string_view fp_CodeSnippet, const unsigned int fp_Depth)
+            const
+        {
+            DispatchBlockNodeEmitter<PythonScriptBackend>(std::make_index_sequence<BLOCK_NODE_KIND_COUNT>{}, fp_Kind, fp_Sink, fp_Name, fp_CodeSnippet, fp_Depth);
+        }
+
+        void
+            EmitBlockClose(const BlockNodeKind, ScriptSink&, const unsigned int) //indentation closes blocks on its own
+            const
+        {
+        }
+
+        [[nodiscard]] bool
+            ContinuesBlock(const BlockNodeKind, const BlockNodeKind)
+            const
+        {
+            return false;
+        }
+    };
+
+    static_assert(BLOCK_NODE_EMITTER_TABLE<PythonScriptBackend>.size() == BLOCK_NODE_KIND_COUNT, "Every BlockNodeKind needs a Python BlockNodeEmitter specialization");
+
+    inline constexpr PythonScriptBackend PYTHON_SCRIPT_BACKEND = {};
+
+    template<typename BACKEND>
+    struct ScriptTarget //one output of a multi target walk, see FlattenedBlockNodeTree::EmitScripts()
+    {
+        const BACKEND& m_Backend;
+        ScriptSink& m_Sink;
+    };
+
+    inline void
+        EmitBlockNode
+        (
+            const BlockNodeKind fp_Kind,
+            ScriptSink& fp_Sink,
+            const std::string_view fp_Name,
+            const std::string_view fp_CodeSnippet,
+            const unsigned int fp_Depth
+        )
+    {
+        PYTHON_SCRIPT_BACKEND.EmitBlockOpen(fp_Kind, fp_Sink, fp_Name, fp_CodeSnippet, fp_Depth); //the incremental codegen path, always Python since that's what gets executed
+    }
+}
@@ -0,0 +1,304 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../Logger.h"
+#include "BlockNodeEmitters.h"
+
+namespace Princess {
+
+    //////////////////////////////////////////////
+    // Config Script Backend
+    //////////////////////////////////////////////
+    /*
+    Backend for target languages nobody wrote emitters for, every kind's text comes from a user config instead:
+
+        # comments start with a hash
+        if = if ({snippet}) {
+        if.end = }
+        else_if = } else if ({snippet}) {
+        else_if.continues = if, else_if
+
+    "<kind> = <template>" is the line written before the node's children, {name} and {snippet} get replaced by the node's m_Name and
+    m_CodeSnippet. "<kind>.end" is the line written once its subtree is done and "<kind>.continues" lists the kinds whose block this one
+    carries on when it directly follows them, so their .end gets skipped. Kinds are spelled like BLOCK_NODE_KIND_NAMES, kinds without a
+    template emit nothing themselves but their children still do. Templates get split into segments once when they're set, emitting
+    never has to look for placeholders again.
+    */
+
+    class ConfigScriptBackend
+    {
+    public:
+        static constexpr bool HAS_BLOCK_TERMINATORS = true; //whether any .end is set is only known at runtime
+
+    public:
+        bool
+            LoadFromConfig(const std::string_view fp_Config) //replaces every template, stops at and prints the first bad line
+        {
+            pm_Templates = {};
+
+            size_t f_LineNumber = 0;
+            std::string_view f_Remaining = fp_Config;
+
+            while (not f_Remaining.empty())
+            {
+                f_LineNumber++;
+
+                const size_t f_LineEnd = std::min(f_Remaining.find('\n'), f_Remaining.size());
+                const std::string_view f_Line = Trim(f_Remaining.substr(0, f_LineEnd));
+                f_Remaining.remove_prefix(std::min(f_LineEnd + 1, f_Remaining.size()));
+
+                if (f_Line.empty() or f_Line.front() == '#')
+                {
+                    continue;
+                }
+
+                const size_t f_Equals = f_Line.find('=');
+
+                if (f_Equals == std::string_view::npos)
+                {
+                    PrintError(format("Script backend config line {} is missing an '=': {}", f_LineNumber, f_Line));
+                    return false;
+                }
+
+                std::string_view f_Key = Trim(f_Line.substr(0, f_Equals));
+                const std::string_view f_Value = Trim(f_Line.substr(f_Equals + 1));
+
+                std::string_view f_Field = "";
+                const size_t f_Dot = f_Key.find('.');
+
+                if (f_Dot != std::string_view::npos)
+                {
+                    f_Field = f_Key.substr(f_Dot + 1);
+                    f_Key = f_Key.substr(0, f_Dot);
+                }
+
+                const std::optional<BlockNodeKind> f_Kind = FindKind(f_Key);
+
+                if (not f_Kind)
+                {
+                    PrintError(format("Script backend config line {} names an unknown block node kind: {}", f_LineNumber, f_Key));
+                    return false;
+                }
+
+                if (f_Field.empty())
+                {
+                    SetOpenTemplate(*f_Kind, f_Value);
+                }
+                else if (f_Field == "end")
+                {
+                    SetCloseLine(*f_Kind, f_Value);
+                }
+                else if (f_Field == "continues")
+                {
+                    if (not ParseContinuedKinds(*f_Kind, f_Value))
+                    {
+                        PrintError(format("Script backend config line {} lists an unknown block node kind: {}", f_LineNumber, f_Value));
+                        return false;
+                    }
+                }
+                else
+                {
+                    PrintError(format("Script backend config line {} has an unknown field: {}", f_LineNumber, f_Field));
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        void
+            SetOpenTemplate(const BlockNodeKind fp_Kind, const std::string_view fp_Template)
+        {
+            KindTemplate& f_Template = pm_Templates[static_cast<size_t>(fp_Kind)];
+
+            f_Template.m_Literals.clear();
+            f_Template.m_OpenSegments.clear();
+            f_Template.m_HasOpen = true;
+
+            size_t f_LiteralStart = 0;
+
+            auto f_FlushLiteral = [&](const size_t fp_End)
+            {
+                if (fp_End > f_LiteralStart)
+                {
+                    f_Template.m_OpenSegments.push_back({ SegmentType::Literal, static_cast<uint32_t>(f_Template.m_Literals.size()), static_cast<uint32_t>(fp_End - f_LiteralStart) });
+                    f_Template.m_Literals += fp_Template.substr(f_LiteralStart, fp_End - f_LiteralStart);
+                }
+            };
+
+            for (size_t l_Position = fp_Template.find('{'); l_Position != std::string_view::npos; l_Position = fp_Template.find('{', l_Position + 1))
+            {
+                const std::string_view f_Rest = fp_Template.substr(l_Position);
+                const SegmentType f_Type = f_Rest.starts_with(NAME_PLACEHOLDER) ? SegmentType::Name : f_Rest.starts_with(SNIPPET_PLACEHOLDER) ? SegmentType::CodeSnippet : SegmentType::Literal;
+
+                if (f_Type == SegmentType::Literal) //any other brace is just part of the target language
+                {
+                    continue;
+                }
+
+                f_FlushLiteral(l_Position);
+                f_Template.m_OpenSegments.push_back({ f_Type, 0, 0 });
+
+                f_LiteralStart = l_Position + (f_Type == SegmentType::Name ? NAME_PLACEHOLDER.size() : SNIPPET_PLACEHOLDER.size());
+                l_Position = f_LiteralStart - 1;
+            }
+
+            f_FlushLiteral(fp_Template.size());
+        }
+
+        void
+            SetCloseLine(const BlockNodeKind fp_Kind, const std::string_view fp_CloseLine) //empty means the kind never needs closing
+        {
+            pm_Templates[static_cast<size_t>(fp_Kind)].m_CloseLine = fp_CloseLine;
+        }
+
+        void
+            SetBlockContinuation(const BlockNodeKind fp_ClosingKind, const BlockNodeKind fp_NextKind) //fp_NextKind directly after fp_ClosingKind skips fp_ClosingKind's close line
+        {
+            pm_Templates[static_cast<size_t>(fp_NextKind)].m_ContinuedKinds |= 1u << static_cast<uint32_t>(fp_ClosingKind);
+        }
+
+        //////////////////// Backend Policy ////////////////////
+
+        void
+            EmitBlockOpen(const BlockNodeKind fp_Kind, ScriptSink& fp_Sink, const std::string_view fp_Name, const std::string_view fp_CodeSnippet, const unsigned int fp_Depth)
+            const
+        {
+            const KindTemplate& f_Template = pm_Templates[static_cast<size_t>(fp_Kind)];
+
+            if (not f_Template.m_HasOpen) { return; }
+
+            fp_Sink.Indent(fp_Depth);
+
+            for (const TemplateSegment& l_Segment : f_Template.m_OpenSegments)
+            {
+                switch (l_Segment.m_Type)
+                {
+                case SegmentType::Literal: fp_Sink.Append(std::string_view(f_Template.m_Literals).substr(l_Segment.m_Offset, l_Segment.m_Length)); break;
+                case SegmentType::Name: fp_Sink.Append(fp_Name); break;
+                case SegmentType::CodeSnippet: fp_Sink.Append(fp_CodeSnippet); break;
+                }
+            }
+
+            fp_Sink.Append('\n');
+        }
+
+        void
+            EmitBlockClose(const BlockNodeKind fp_Kind, ScriptSink& fp_Sink, const unsigned int fp_Depth)
+            const
+        {
+            const std::string& f_CloseLine = pm_Templates[static_cast<size_t>(fp_Kind)].m_CloseLine;
+
+            if (not f_CloseLine.empty())
+            {
+                fp_Sink.Indent(fp_Depth).Append(f_CloseLine).Append('\n');
+            }
+        }
+
+        [[nodiscard]] bool
+            ContinuesBlock(const BlockNodeKind fp_ClosingKind, const BlockNodeKind fp_NextKind)
+            const
+        {
+            return (pm_Templates[static_cast<size_t>(fp_NextKind)].m_ContinuedKinds >> static_cast<uint32_t>(fp_ClosingKind)) & 1u;
+        }
+
+    private:
+        enum class SegmentType : unsigned char
+        {
+            Literal,
+            Name,
+            CodeSnippet
+        };
+
+        struct TemplateSegment
+        {
+            SegmentType m_Type;
+            uint32_t m_Offset; //into KindTemplate::m_Literals, literals only
+            uint32_t m_Length;
+        };
+
+        struct KindTemplate
+        {
+            bool m_HasOpen = false;
+            std::vector<TemplateSegment> m_OpenSegments = {};
+            std::string m_Literals;
+            std::string m_CloseLine;
+            uint32_t m_ContinuedKinds = 0; //bit per BlockNodeKind this one carries on from
+        };
+
+        static_assert(BLOCK_NODE_KIND_COUNT <= 32, "KindTemplate::m_ContinuedKinds needs a wider mask");
+
+        static constexpr std::string_view NAME_PLACEHOLDER = "{name}";
+        static constexpr std::string_view SNIPPET_PLACEHOLDER = "{snippet}";
+
+        static std::string_view
+            Trim(std::string_view fp_Text)
+        {
+            while (not fp_Text.empty() and (fp_Text.front() == ' ' or fp_Text.front() == '\t' or fp_Text.front() == '\r'))
+            {
+                fp_Text.remove_prefix(1);
+            }
+
+            while (not fp_Text.empty() and (fp_Text.back() == ' ' or fp_Text.back() == '\t' or fp_Text.back() == '\r'))
+            {
+                fp_Text.remove_suffix(1);
+            }
+
+            return fp_Text;
+        }
+
+        static std::optional<BlockNodeKind>
+            FindKind(const std::string_view fp_Name)
+        {
+            for (size_t l_Kind = 0; l_Kind < BLOCK_NODE_KIND_COUNT; l_Kind++)
+            {
+                if (BLOCK_NODE_KIND_NAMES[l_Kind] == fp_Name)
+                {
+                    return static_cast<BlockNodeKind>(l_Kind);
+                }
+            }
+
+            return std::nullopt;
+        }
+
+        bool
+            ParseContinuedKinds(const BlockNodeKind fp_Kind, std::string_view fp_List)
+        {
+            while (not fp_List.empty())
+            {
+                const size_t f_Comma = std::min(fp_List.find(','), fp_List.size());
+                const std::optional<BlockNodeKind> f_ClosingKind = FindKind(Trim(fp_List.substr(0, f_Comma)));
+
+                if (not f_ClosingKind)
+                {
+                    return false;
+                }
+
+                SetBlockContinuation(*f_ClosingKind, fp_Kind);
+                fp_List.remove_prefix(std::min(f_Comma + 1, fp_List.size()));
+            }
+
+            return true;
+        }
+
+    private:
+        std::array<KindTemplate, BLOCK_NODE_KIND_COUNT> pm_Templates = {};
+    };
+}
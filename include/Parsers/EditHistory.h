@@ -0,0 +1,66 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "../BlockNode.h"
+
+namespace Princess {
+
+    //////////////////////////////////////////////
+    // Block Node Placement
+    //////////////////////////////////////////////
+
+    struct BlockNodePlacement //everything that decides where a node sits and when it runs
+    {
+        static constexpr uint32_t NOT_IN_EXECUTION_ORDER = UINT32_MAX;
+
+        BlockNodeHandle m_ParentID = {}; //null for the top level
+        uint32_t m_SiblingIndex = 0; //into the parent's m_Children, or into the top level list
+        uint32_t m_ExecutionIndex = NOT_IN_EXECUTION_ORDER; //so blocks sharing a line number come back in the same order
+        unsigned int m_InputLineNumber = 0;
+        bool m_IsRootExecutable = false;
+
+        friend constexpr bool operator==(const BlockNodePlacement&, const BlockNodePlacement&) = default;
+    };
+
+    //////////////////////////////////////////////
+    // Edit Commands
+    //////////////////////////////////////////////
+    /*
+    The undo log never snapshots the graph. Every command stores the one piece of state the node doesn't currently have, and undoing or
+    redoing it just swaps that with what the node has now, so the same code runs in both directions and a command costs the size of the
+    edit: a placement, the old text, or a pointer to a removed subtree.
+    Removed subtrees aren't destroyed while a command can still bring them back, their nodes get retired from the slot map with their
+    children intact and come back under the same handles. Whoever drops a command holding m_RetainedBlockNode frees that subtree for good.
+    */
+
+    enum class EditCommandKind : unsigned char
+    {
+        Liveness, //created or removed, m_RetainedBlockNode is set while the node is out of the graph
+        Placement, //reparented, flagged/unflagged or moved to another input line
+        Name,
+        CodeSnippet
+    };
+
+    struct EditCommand
+    {
+        EditCommandKind m_Kind;
+        BlockNodeHandle m_ID;
+        uint64_t m_Step = 0; //commands sharing a step get undone and redone together
+
+        BlockNodePlacement m_OtherPlacement = {}; //Liveness and Placement, where the node goes back to when this gets swapped
+        std::string m_OtherText = ""; //Name and CodeSnippet
+        BlockNode* m_RetainedBlockNode = nullptr;
+    };
+}
@@ -10,9 +10,20 @@
 /////////////////////////////////////////////////////////
 #pragma once
 
+#include <chrono>
 #include <vector>
-#include "../BlockNode.h"
+#include <unordered_map>
+#include "../AtomicBitset.h"
+#include "../BlockNodeArena.h"
+#include "../BlockNodeTraversal.h"
 #include "../Logger.h"
+#include "../WorkerPool.h"
+#include "EditHistory.h"
+#include "FlattenedBlockNodeTree.h"
+#include "GraphDiagnostics.h"
+#include "ScriptHash.h"
+#include "ScriptOptimizer.h"
+#include "ScriptSourceMap.h"
 
 
 namespace Princess {
@@ -28,46 +39,250 @@ namespace Princess {
         }
 
     public:
-        std::vector<std::unique_ptr<BlockNode>>& GetRootLevelBlockNodeExecutionOrder();
+        static constexpr size_t DEFAULT_UNDO_HISTORY_LIMIT = 10'000; //in steps
 
-        void FindAndRemoveBlockNode(BlockNode* fp_NodeToBeRemoved);
+        template<typename T, typename... Args>
+        T* CreateBlockNode(Args&&... fp_Args) //allocates the node inside the graph's arena, hands out a fresh handle and places it at the top level of the scene
+        {
+            const BlockNodeHandle f_ID = pm_BlockNodeSlotMap.Insert(nullptr); //reserve the slot first, the node needs its handle at construction
+
+            T* f_BlockNode = pm_BlockNodeArena.Create<T>(std::forward<Args>(fp_Args)..., f_ID);
+            *pm_BlockNodeSlotMap.Get(f_ID) = f_BlockNode;
+            pm_AllCurrentlyPlacedBlockNodes.push_back(f_BlockNode);
+            pm_AllCurrentlyPlacedBlockNodeIDs.push_back(f_ID);
+            MarkGraphDirty();
+            RecordEdit({ EditCommandKind::Liveness, f_ID });
+            return f_BlockNode;
+        }
+
+        void ClearAllBlockNodes();
+
+        BlockNode* FindBlockNode(const BlockNodeHandle fp_BlockNodeID) const;
+        bool IsBlockNodeHandleValid(const BlockNodeHandle fp_BlockNodeID) const;
+
+        const std::vector<BlockNode*>& GetRootLevelBlockNodeExecutionOrder() const; //always sorted by m_InputLineNumber
+
+        void FindAndRemoveBlockNode(const BlockNodeHandle fp_NodeToBeRemoved);
+
+        bool FlagBlockNodeForRootLevelExecution(const BlockNodeHandle fp_BlockNodeID); //only top level nodes can be flagged
+        bool RemoveFlagFromBlockNodeForRootLevelExecution(const BlockNodeHandle fp_BlockNodeID);
+        bool SetBlockNodeInputLineNumber(const BlockNodeHandle fp_BlockNodeID, const unsigned int fp_InputLineNumber); //moves flagged nodes to their new spot in the execution order
+
+        bool ReparentBlockNode(const BlockNodeHandle fp_BlockNodeID, const BlockNodeHandle fp_NewParentID = {}); //a null fp_NewParentID moves the node back to the top level
+
+        bool SetBlockNodeName(const BlockNodeHandle fp_BlockNodeID, const std::string& fp_Name);
+        bool SetBlockNodeCodeSnippet(const BlockNodeHandle fp_BlockNodeID, const std::string& fp_CodeSnippet);
+
+        void MarkBlockNodeDirty(const BlockNodeHandle fp_BlockNodeID); //call after editing BlockNode fields directly instead of going through the setters above, those edits can't be undone
+        void MarkGraphDirty();
+
+        const FlattenedBlockNodeTree* CompileBlockNodeTree(const BlockNodeHandle fp_RootID); //lazily rebuilt preorder snapshot, nullptr for invalid handles
+
+        uint64_t GetBlockNodeSubtreeHash(const BlockNodeHandle fp_BlockNodeID); //Merkle hash of the node's whole subtree, equal hashes mean identical code, 0 for invalid handles
+        uint64_t GetGraphHash(); //every flagged root in execution order plus the optimization passes, cached until the next edit
+        bool HasGraphChangedSinceLastRun(); //compares content, so edits that got undone (or retyped) don't count as changes
 
-        void FlagBlockNodeForRootLevelExecution(const unsigned int fp_BlockNodeID);
-        void RemoveFlagFromBlockNodeForRootLevelExecution(const unsigned int fp_BlockNodeID);
+        std::string_view GenerateFullScript(); //sorted root-level script without running it, useful for batch compiling and exporting
+        uint64_t GetCurrentScriptHash() const; //HashScript() of the last generated script
 
-        void ReparentBlockNode();
+        template<typename... BACKENDS>
+        void ExportRootLevelScripts(const ScriptTarget<BACKENDS>&... fp_Targets); //appends the sorted root-level script in every target language from one walk per root, doesn't touch pm_CurrentScript
 
-        void ExecuteScript();
+        void SetScriptOptimizationPasses(const ScriptOptimizationPasses fp_Passes); //None (the default) emits the graph exactly as built, changing it regenerates every top level node on the next run
+        ScriptOptimizationPasses GetScriptOptimizationPasses() const;
+
+        const ScriptSourceMap& GetCurrentSourceMap() const; //line -> node table for the last generated script, built during codegen
+        BlockNodeHandle FindBlockNodeAtScriptLine(const uint32_t fp_LineNumber) const; //1-based line of the last generated script (eg. from a traceback), O(log n), null handle if no node emitted it
+
+        bool Undo(); //reverts the last edit step, false when there's nothing left to undo
+        bool Redo(); //any new edit throws away everything that could still be redone
+        bool CanUndo() const;
+        bool CanRedo() const;
+
+        void BeginEditStep(); //every edit until the matching EndEditStep() gets undone as one step, nests
+        void EndEditStep();
+
+        void SetUndoHistoryLimit(const size_t fp_StepCount); //oldest steps get dropped past this, 0 stops recording and frees the history
+        void ClearEditHistory(); //frees every removed subtree the history was keeping around for undo
+
+        const GraphValidationReport& ValidateGraph(); //structural checks over every node, cached until the graph changes, ExecuteScript() refuses to run a graph that fails them
+
+        uint64_t ExecuteScript(const std::chrono::milliseconds fp_Timeout = std::chrono::milliseconds::zero()); //queues the script on PythonScriptParser's script thread and returns its run ID (0 on failure or an invalid graph) without waiting for it
 
     public:
 
     private:
         ExecutionParser() = default;
-        ~ExecutionParser() = default;
+        ~ExecutionParser() = default; //pm_BlockNodeArena releases every node of the graph in bulk
 
         ExecutionParser(const ExecutionParser&) = delete;
         ExecutionParser& operator=(const ExecutionParser&) = delete;
 
     private:
-        void DFS(const BlockNode* fp_Node, unsigned int fp_Depth, std::string& fp_Script) const;
-        BlockNode* DFSFindBlockNodeReferenceInTree(const unsigned int fp_BlockNodeID, const bool fp_IsLookingForRoot = true);
-        BlockNode* DFSReturnSpecificBlockNodePointerReference(BlockNode* fp_BlockNode, const unsigned int fp_BlockNodeID);
+        void DFS(const BlockNode* fp_Node, unsigned int fp_Depth, ScriptSink& fp_Sink);
+        BlockNode* DFSFindBlockNodeReferenceInTree(const BlockNodeHandle fp_BlockNodeID, const bool fp_IsLookingForRoot = true);
+        BlockNode* DFSReturnSpecificBlockNodePointerReference(BlockNode* fp_BlockNode, const BlockNodeHandle fp_BlockNodeID);
 
-        void MovePointerReferencesToRootLevelBlockNodeExecutionOrder();
+        void DetachBlockNodeFromParent(BlockNode* fp_BlockNode);
+        void MarkBlockNodeDirty(BlockNode* fp_BlockNode);
+        void InvalidateBlockNodeSubtreeScripts(BlockNode* fp_BlockNode);
+        void DestroyBlockNodeSubtree(BlockNode* fp_BlockNode);
 
-        void SortRootLevelBlockNodeExecutionOrder();
-        bool CheckIfSorted();
+        void InsertIntoRootLevelBlockNodeExecutionOrder(BlockNode* fp_BlockNode);
+        void EraseFromRootLevelBlockNodeExecutionOrder(BlockNode* fp_BlockNode);
 
-        void MovePointerReferencesBackToAllCurrentlyPlacedBlockNodes();
+        uint64_t RunPythonScript(const std::chrono::milliseconds fp_Timeout);
 
-        void RunPythonScript();
+        void GenerateRootLevelScript(); //fills pm_CurrentScript from pm_RootLevelBlockNodeExecutionOrder, dirty roots get regenerated in parallel
+        void GenerateScript(BlockNode* fp_StartingBlockNode, ScriptSink& fp_Sink); //appends to fp_Sink, reuse one sink across runs to stay allocation free
+
+        struct IncrementalEmissionFrame //a node getting re-emitted, its children's cached offsets are relative to these
+        {
+            size_t m_PreviousStart = 0; //where its text started in the previous run
+            size_t m_Start = 0;
+            size_t m_PreviousEntry = 0; //same for its source map entry
+            size_t m_Entry = 0;
+            unsigned int m_LineCount = 0; //so far, children add theirs as they finish
+            unsigned int m_NodeCount = 0;
+        };
+
+        struct IncrementalEmission //state shared by one top level node's EmitIncrementally() walk
+        {
+            const std::string& m_PreviousScript;
+            const ScriptSourceMap& m_PreviousSourceMap;
+            ScriptSink& m_Sink;
+            ScriptSourceMap& m_SourceMap;
+            std::vector<IncrementalEmissionFrame>& m_Frames; //the re-emitted nodes on the current path, below a zeroed frame for the top level node's parent
+            uint32_t m_Line = 0; //newlines emitted so far
+        };
+
+        void EmitIncrementally(BlockNode* fp_TopLevelBlockNode, IncrementalEmission& fp_Emission, BlockNodeTraversal& fp_Traversal);
+
+        struct CodegenScratch //everything one thread needs to regenerate a top level node, reused between runs so it stops allocating once it's warmed up
+        {
+            ScriptSink m_Sink;
+            ScriptSourceMap m_SourceMap;
+            FlattenedBlockNodeTree m_Snapshot; //only used while optimization passes are enabled
+            ScriptOptimizer m_Optimizer;
+            BlockNodeTraversal m_Traversal;
+            std::vector<IncrementalEmissionFrame> m_EmissionFrames = {};
+        };
+
+        void RefreshTopLevelScriptCache(BlockNode* fp_TopLevelBlockNode, ScriptSourceMap& fp_SourceMap, CodegenScratch& fp_Scratch);
+        void MarkBlockNodeSubtreeClean(BlockNode* fp_BlockNode, BlockNodeTraversal& fp_Traversal);
+
+        uint64_t UpdateBlockNodeSubtreeHash(BlockNode* fp_BlockNode, BlockNodeTraversal& fp_Traversal); //rehashes dirty nodes only, clean branches reuse m_SubtreeHash
+        void FindTopLevelScriptDonors(); //fills pm_RootScriptDonors for dirty roots identical to another root
+        bool ShareTopLevelScriptCache(const size_t fp_DonorIndex, const size_t fp_RecipientIndex); //false if the subtrees only shared a hash, nothing gets touched then
+
+        bool IsRecordingEdits() const;
+        void RecordEdit(EditCommand&& fp_Command); //call after the edit went through
+        void RecordPlacementEdit(const BlockNode* fp_BlockNode, const BlockNodePlacement& fp_PreviousPlacement);
+        void ApplyEditCommand(EditCommand& fp_Command); //swaps the command's state with the graph's, undo and redo are the same call
+        void DropEditCommand(EditCommand& fp_Command);
+        void DropRedoableEditCommands();
+        void DropOldestEditStep();
+
+        BlockNodePlacement CaptureBlockNodePlacement(const BlockNode* fp_BlockNode) const;
+        void SwapBlockNodePlacement(BlockNode* fp_BlockNode, BlockNodePlacement& fp_Placement);
+        void PlaceBlockNode(BlockNode* fp_BlockNode, const BlockNodePlacement& fp_Placement); //puts a detached node back exactly where fp_Placement says
+
+        void RetireBlockNodeSubtree(BlockNode* fp_BlockNode);
+        void ReviveBlockNodeSubtree(BlockNode* fp_BlockNode);
+        void DestroyRetiredBlockNodeSubtree(BlockNode* fp_BlockNode);
+
+        std::vector<BlockNode*>::iterator FindInRootLevelBlockNodeExecutionOrder(const BlockNode* fp_BlockNode); //end() if it isn't in there
+
+        struct ValidationScratch //per WorkerPool thread, merged into pm_ValidationReport once every thread is done
+        {
+            std::vector<GraphDiagnostic> m_Diagnostics = {};
+            struct Frame
+            {
+                BlockNode* m_BlockNode;
+                size_t m_PendingStart; //children of m_BlockNode to walk are m_PendingBlockNodes[m_PendingStart, m_PendingEnd)
+                size_t m_NextPending;
+                size_t m_PendingEnd;
+            };
+
+            std::vector<Frame> m_Stack = {}; //doubles as the current path for cycle checks
+            std::vector<BlockNode*> m_PendingBlockNodes = {};
+            std::vector<BlockNode*> m_UnreachedBlockNodes = {};
+        };
+
+        void ValidateBlockNodeSubtree(BlockNode* fp_TopLevelBlockNode, ValidationScratch& fp_Scratch); //walks m_Children, marks everything it reaches in pm_ValidationVisited
+        void ValidateBlockNodeChildren(BlockNode* fp_BlockNode, ValidationScratch& fp_Scratch); //checks every child at once and pushes a frame for the ones to walk into
+        void ValidateUnreachedBlockNodes(); //explains why each node the walks missed is unreachable
+        void AddIfChainDiagnostic(const BlockNode* fp_BlockNode, const BlockNode* fp_PreviousSibling, std::vector<GraphDiagnostic>& fp_Diagnostics) const;
 
-        std::string GenerateScript(const BlockNode* fp_StartingBlockNode) const;
 
 	private:
-		std::vector<std::unique_ptr<BlockNode>> pm_RootLevelBlockNodeExecutionOrder = {}; //stores all the blocks that are to be executed for when they're glued back together into a plain old .py file and their branches 
-        std::vector<std::unique_ptr<BlockNode>> pm_AllCurrentlyPlacedBlockNodes = {};
+        BlockNodeArena pm_BlockNodeArena; //owns every BlockNode in the graph, the vectors below only hold non-owning references
+
+		std::vector<BlockNode*> pm_RootLevelBlockNodeExecutionOrder = {}; //flagged top level blocks kept sorted by m_InputLineNumber as they get flagged/unflagged, so running never has to shuffle or sort anything
+        std::vector<BlockNode*> pm_AllCurrentlyPlacedBlockNodes = {}; //every top level block, flagged or not
+        std::vector<BlockNodeHandle> pm_AllCurrentlyPlacedBlockNodeIDs = {}; //same order as the list above, what BlockNode::m_ChildIDs is to m_Children
 
-        std::string pm_CurrentScript;
+        SlotMap<BlockNode*> pm_BlockNodeSlotMap; //handle -> node index, removed nodes bump their slot's generation so old handles read back as nullptr
+
+        uint64_t pm_GraphRevision = 1; //bumped on every structural or text edit, top level nodes get stamped with it when something below them changes
+        std::unordered_map<uint32_t, FlattenedBlockNodeTree> pm_FlattenedBlockNodeTrees = {}; //keyed by the root's slot index
+        uint64_t pm_SnapshotEpoch = 1; //see BlockNode::m_SnapshotDirtyEpoch, bumped whenever a cached snapshot gets rebuilt
+        std::vector<uint32_t> pm_ExportOpenBlocks = {}; //scratch stack for ExportRootLevelScripts(), shared by every root it emits
+        std::unordered_map<uint32_t, ScriptSourceMap> pm_TopLevelSourceMaps = {}; //same keying, goes with each top level node's m_CachedScript, lines relative to the start of that text
+
+        CodegenScratch pm_IncrementalScratch; //for codegen kicked off on this thread
+        BlockNodeTraversal pm_Traversal; //every other walk on this thread, workers use their CodegenScratch's
+        std::vector<CodegenScratch> pm_WorkerScratch = {}; //one per WorkerPool thread for parallel root generation
+        ScriptOptimizationPasses pm_ScriptOptimizationPasses = ScriptOptimizationPasses::None;
+        std::vector<ScriptSourceMap*> pm_RootSourceMaps = {}; //parallel to pm_RootLevelBlockNodeExecutionOrder while generating
+
+        static constexpr size_t NO_SCRIPT_DONOR = SIZE_MAX;
+
+        std::vector<size_t> pm_RootScriptDonors = {}; //parallel to pm_RootLevelBlockNodeExecutionOrder, root whose cache gets copied instead of generating
+        std::vector<uint64_t> pm_RootShallowKeys = {}; //parallel to pm_RootLevelBlockNodeExecutionOrder, root kind + own text + child count
+        std::unordered_map<uint64_t, uint32_t> pm_RootShallowKeyCounts = {}; //only roots that collide here get fully hashed
+        std::vector<size_t> pm_RootScriptDonorCandidates = {};
+        std::unordered_map<uint64_t, size_t> pm_RootIndicesBySubtreeHash = {};
+        std::vector<std::pair<BlockNode*, BlockNode*>> pm_SharedBlockNodePairs = {}; //donor + recipient, breadth first, scratch for ShareTopLevelScriptCache()
+        std::vector<BlockNodeHandle> pm_SharedBlockNodeIDs = {}; //donor slot index -> recipient handle, only entries of the current donor are meaningful
+        uint64_t pm_GraphHash = 0;
+        uint64_t pm_GraphHashRevision = 0; //graph revision pm_GraphHash was taken at
+        uint64_t pm_LastRunGraphHash = 0;
+
+        ScriptSink pm_CurrentScript;
+        uint64_t pm_CurrentScriptRevision = 0; //graph revision pm_CurrentScript was generated at, matching pm_GraphRevision means nothing changed and codegen gets skipped
+        uint64_t pm_CurrentScriptHash = SCRIPT_HASH_SEED;
+        ScriptSourceMap pm_CurrentSourceMap; //always generated together with pm_CurrentScript
+
+        GraphValidationReport pm_ValidationReport;
+        AtomicBitset pm_ValidationVisited; //one bit per slot index
+        std::vector<BlockNode*> pm_ValidationTopLevelBlockNodes = {}; //distinct, live top level nodes the walks start from
+        std::vector<ValidationScratch> pm_WorkerValidationScratch = {};
+        std::vector<uint8_t> pm_ValidationWalkStates = {}; //per slot index, only touched for unreachable nodes: 0 unseen, 1 on the current parent walk, 2 done
+
+        std::vector<EditCommand> pm_EditHistory = {}; //oldest first, [pm_EditHistoryFront, pm_EditHistoryCursor) is applied and the rest can be redone
+        size_t pm_EditHistoryFront = 0; //dropped steps just move this up, the dead prefix gets erased in bulk once it's half the vector
+        size_t pm_EditHistoryCursor = 0;
+        size_t pm_EditHistoryStepCount = 0;
+        size_t pm_UndoHistoryLimit = DEFAULT_UNDO_HISTORY_LIMIT;
+        uint64_t pm_NextEditStep = 1;
+        uint64_t pm_OpenEditStep = 0;
+        unsigned int pm_EditStepDepth = 0;
+        bool pm_IsReplayingEdits = false; //undo/redo go through the same helpers as regular edits, this keeps them from being recorded again
     };
+
+    template<typename... BACKENDS>
+    void
+        ExecutionParser::ExportRootLevelScripts(const ScriptTarget<BACKENDS>&... fp_Targets)
+    {
+        for (const BlockNode* l_Root : pm_RootLevelBlockNodeExecutionOrder)
+        {
+            const FlattenedBlockNodeTree* f_Tree = CompileBlockNodeTree(l_Root->m_ID); //cached snapshot, only rebuilt when something under this root changed since
+
+            if (f_Tree != nullptr)
+            {
+                f_Tree->EmitScripts(pm_ExportOpenBlocks, fp_Targets...);
+            }
+        }
+    }
 }
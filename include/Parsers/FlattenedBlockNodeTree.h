@@ -0,0 +1,254 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../BlockNode.h"
+#include "ScriptSourceMap.h"
+
+namespace Princess {
+
+    //////////////////////////////////////////////
+    // Flattened Block Node Entry
+    //////////////////////////////////////////////
+
+    struct FlattenedBlockNode
+    {
+        BlockNodeHandle m_ID;
+        BlockNodeKind m_Kind;
+
+        uint32_t m_Depth; //0 for the root of the snapshot
+        uint32_t m_SubtreeSize; //counts the node itself, so the subtree of entry i is [i, i + m_SubtreeSize)
+
+        uint32_t m_NameOffset; //offsets and lengths point into FlattenedBlockNodeTree::m_StringPool
+        uint32_t m_NameLength;
+        uint32_t m_SnippetOffset;
+        uint32_t m_SnippetLength;
+    };
+
+    //////////////////////////////////////////////
+    // Flattened Block Node Tree
+    //////////////////////////////////////////////
+    /*
+    Contiguous preorder snapshot of one root's subtree. Every string the emitter needs gets copied into a single pool, so codegen, searching
+    and validation become linear scans over a flat array instead of chasing child pointers, and deep trees can't overflow the call stack
+    since Build() walks the tree with an explicit stack.
+    */
+
+    struct FlattenedBlockNodeTree
+    {
+    public:
+        BlockNodeHandle m_RootID = {};
+        uint64_t m_BuiltAtRevision = 0; //m_SnapshotRevision of the root's top level node when this was taken, a different stamp means something below it changed
+
+        std::vector<FlattenedBlockNode> m_Nodes = {};
+        std::string m_StringPool;
+
+    public:
+        void
+            Build(const BlockNode* fp_Root, const uint64_t fp_Revision)
+        {
+            m_Nodes.clear();
+            m_StringPool.clear();
+
+            m_RootID = fp_Root ? fp_Root->m_ID : BlockNodeHandle{};
+            m_BuiltAtRevision = fp_Revision;
+
+            if (not fp_Root)
+            {
+                return;
+            }
+
+            struct PendingBlockNode
+            {
+                const BlockNode* m_Node;
+                uint32_t m_Depth;
+            };
+
+            std::vector<PendingBlockNode> f_Stack = { { fp_Root, 0 } };
+            std::vector<uint32_t> f_OpenAncestors; //indices into m_Nodes of the nodes whose subtree is still being written
+
+            while (not f_Stack.empty())
+            {
+                const PendingBlockNode f_Current = f_Stack.back();
+                f_Stack.pop_back();
+
+                while (not f_OpenAncestors.empty() and m_Nodes[f_OpenAncestors.back()].m_Depth >= f_Current.m_Depth) //everything at our depth or deeper is finished once we pop a sibling
+                {
+                    CloseSubtree(f_OpenAncestors.back());
+                    f_OpenAncestors.pop_back();
+                }
+
+                const BlockNode* f_Node = f_Current.m_Node;
+
+                FlattenedBlockNode f_Entry;
+                f_Entry.m_ID = f_Node->m_ID;
+                f_Entry.m_Kind = f_Node->m_Kind;
+                f_Entry.m_Depth = f_Current.m_Depth;
+                f_Entry.m_SubtreeSize = 1;
+                f_Entry.m_NameOffset = static_cast<uint32_t>(m_StringPool.size());
+                f_Entry.m_NameLength = static_cast<uint32_t>(f_Node->m_Name.size());
+                m_StringPool += f_Node->m_Name;
+                f_Entry.m_SnippetOffset = static_cast<uint32_t>(m_StringPool.size());
+                f_Entry.m_SnippetLength = static_cast<uint32_t>(f_Node->m_CodeSnippet.size());
+                m_StringPool += f_Node->m_CodeSnippet;
+
+                f_OpenAncestors.push_back(static_cast<uint32_t>(m_Nodes.size()));
+                m_Nodes.push_back(f_Entry);
+
+                for (auto l_Child = f_Node->m_Children.rbegin(); l_Child != f_Node->m_Children.rend(); ++l_Child) //pushed in reverse so the first child gets popped first
+                {
+                    f_Stack.push_back({ *l_Child, f_Current.m_Depth + 1 });
+                }
+            }
+
+            while (not f_OpenAncestors.empty())
+            {
+                CloseSubtree(f_OpenAncestors.back());
+                f_OpenAncestors.pop_back();
+            }
+        }
+
+        [[nodiscard]] bool
+            IsUpToDate(const BlockNodeHandle fp_RootID, const uint64_t fp_Revision)
+            const
+        {
+            return m_RootID == fp_RootID and m_BuiltAtRevision == fp_Revision;
+        }
+
+        [[nodiscard]] std::string_view
+            GetName(const FlattenedBlockNode& fp_Entry)
+            const
+        {
+            return std::string_view(m_StringPool).substr(fp_Entry.m_NameOffset, fp_Entry.m_NameLength);
+        }
+
+        [[nodiscard]] std::string_view
+            GetCodeSnippet(const FlattenedBlockNode& fp_Entry)
+            const
+        {
+            return std::string_view(m_StringPool).substr(fp_Entry.m_SnippetOffset, fp_Entry.m_SnippetLength);
+        }
+
+        [[nodiscard]] int64_t
+            FindIndex(const BlockNodeHandle fp_BlockNodeID) //linear scan, returns -1 if the node isn't part of this snapshot
+            const
+        {
+            for (size_t l_Index = 0; l_Index < m_Nodes.size(); l_Index++)
+            {
+                if (m_Nodes[l_Index].m_ID == fp_BlockNodeID)
+                {
+                    return static_cast<int64_t>(l_Index);
+                }
+            }
+
+            return -1;
+        }
+
+        void
+            EmitScript(ScriptSink& fp_Sink) //linear scan emission, produces exactly what ExecutionParser::DFS produces for the same root
+            const
+        {
+            std::vector<uint32_t> f_OpenBlocks = {}; //python has no block terminators, so this never gets pushed to and never allocates
+
+            EmitScripts(f_OpenBlocks, ScriptTarget<PythonScriptBackend>{ PYTHON_SCRIPT_BACKEND, fp_Sink });
+        }
+
+        uint32_t
+            EmitScript(ScriptSink& fp_Sink, ScriptSourceMap& fp_SourceMap) //same output, also appends an entry per node to fp_SourceMap and returns the newlines written
+            const
+        {
+            uint32_t f_Line = 0;
+
+            for (const FlattenedBlockNode& l_Entry : m_Nodes)
+            {
+                const size_t f_Start = fp_Sink.Size();
+
+                fp_SourceMap.Append(f_Line, l_Entry.m_ID);
+                EmitBlockNode(l_Entry.m_Kind, fp_Sink, GetName(l_Entry), GetCodeSnippet(l_Entry), l_Entry.m_Depth);
+
+                const std::string_view f_Text = fp_Sink.View().substr(f_Start);
+                f_Line += static_cast<uint32_t>(std::count(f_Text.begin(), f_Text.end(), '\n'));
+            }
+
+            return f_Line;
+        }
+
+        //one pass over the snapshot feeding every target, eg. EmitScripts(f_OpenBlocks, ScriptTarget{ PYTHON_SCRIPT_BACKEND, f_Python }, ScriptTarget{ LUA_SCRIPT_BACKEND, f_Lua })
+        //fp_OpenBlocks holds the entries whose subtree hasn't finished yet, innermost at the back. Pass the same one every time so emitting stops allocating once it has seen the deepest snapshot
+        template<typename... BACKENDS>
+        void
+            EmitScripts(std::vector<uint32_t>& fp_OpenBlocks, const ScriptTarget<BACKENDS>&... fp_Targets)
+            const
+        {
+            constexpr bool f_TracksOpenBlocks = (BACKENDS::HAS_BLOCK_TERMINATORS or ...); //Python only walks never touch the stack
+
+            fp_OpenBlocks.clear();
+
+            for (uint32_t l_Index = 0; l_Index < m_Nodes.size(); l_Index++)
+            {
+                const FlattenedBlockNode& f_Entry = m_Nodes[l_Index];
+
+                if constexpr (f_TracksOpenBlocks)
+                {
+                    while (not fp_OpenBlocks.empty() and m_Nodes[fp_OpenBlocks.back()].m_Depth >= f_Entry.m_Depth)
+                    {
+                        (CloseBlock(fp_Targets, m_Nodes[fp_OpenBlocks.back()], &f_Entry), ...);
+                        fp_OpenBlocks.pop_back();
+                    }
+                }
+
+                const std::string_view f_Name = GetName(f_Entry);
+                const std::string_view f_CodeSnippet = GetCodeSnippet(f_Entry);
+
+                (fp_Targets.m_Backend.EmitBlockOpen(f_Entry.m_Kind, fp_Targets.m_Sink, f_Name, f_CodeSnippet, f_Entry.m_Depth), ...);
+
+                if constexpr (f_TracksOpenBlocks)
+                {
+                    fp_OpenBlocks.push_back(l_Index);
+                }
+            }
+
+            while (not fp_OpenBlocks.empty())
+            {
+                (CloseBlock(fp_Targets, m_Nodes[fp_OpenBlocks.back()], nullptr), ...);
+                fp_OpenBlocks.pop_back();
+            }
+        }
+
+    private:
+        template<typename BACKEND>
+        static void
+            CloseBlock(const ScriptTarget<BACKEND>& fp_Target, const FlattenedBlockNode& fp_Closing, const FlattenedBlockNode* fp_Next) //fp_Next is whatever gets emitted right after, null at the end
+        {
+            if constexpr (BACKEND::HAS_BLOCK_TERMINATORS)
+            {
+                if (fp_Next != nullptr and fp_Next->m_Depth == fp_Closing.m_Depth and fp_Target.m_Backend.ContinuesBlock(fp_Closing.m_Kind, fp_Next->m_Kind))
+                {
+                    return;
+                }
+
+                fp_Target.m_Backend.EmitBlockClose(fp_Closing.m_Kind, fp_Target.m_Sink, fp_Closing.m_Depth);
+            }
+        }
+
+        void
+            CloseSubtree(const uint32_t fp_Index)
+        {
+            m_Nodes[fp_Index].m_SubtreeSize = static_cast<uint32_t>(m_Nodes.size()) - fp_Index;
+        }
+    };
+}
@@ -0,0 +1,88 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "../BlockNode.h"
+
+namespace Princess {
+
+    //////////////////////////////////////////////
+    // Graph Diagnostics
+    //////////////////////////////////////////////
+
+    enum class GraphDiagnosticKind : unsigned char
+    {
+        Cycle, //m_ID leads back to itself, through m_Children or through m_ParentID
+        DanglingChild, //m_RelatedID's m_Children holds a removed node (m_ID is that node's old handle, null for a nullptr entry)
+        DanglingParent, //m_ID's m_ParentID (m_RelatedID) doesn't resolve to a node anymore
+        ParentMismatch, //m_ID sits in m_RelatedID's m_Children but its m_ParentID says something else
+        MissingFromParent, //m_ID's m_ParentID is m_RelatedID, which doesn't list it as a child
+        SharedNode, //m_ID is reachable from more than one place, m_RelatedID is the second parent it was found under
+        DuplicateID, //two nodes claim the handle m_ID, or a node's m_ID doesn't match the slot it's stored in
+        TopLevelNodeHasParent, //m_ID is placed at the top level but has m_ParentID m_RelatedID
+        DuplicateTopLevelNode, //m_ID is placed at the top level more than once
+        UnplacedNode, //m_ID has no parent and isn't placed at the top level, nothing can reach it
+        OrphanedElseIf, //m_ID isn't directly preceded by an if/elif, m_RelatedID is the sibling in front of it (null if it's the first)
+        OrphanedElse,
+        COUNT
+    };
+
+    inline constexpr std::string_view
+        GetGraphDiagnosticKindName(const GraphDiagnosticKind fp_Kind)
+    {
+        switch (fp_Kind)
+        {
+        case GraphDiagnosticKind::Cycle: return "cycle";
+        case GraphDiagnosticKind::DanglingChild: return "dangling child";
+        case GraphDiagnosticKind::DanglingParent: return "dangling parent";
+        case GraphDiagnosticKind::ParentMismatch: return "parent mismatch";
+        case GraphDiagnosticKind::MissingFromParent: return "missing from parent";
+        case GraphDiagnosticKind::SharedNode: return "shared node";
+        case GraphDiagnosticKind::DuplicateID: return "duplicate id";
+        case GraphDiagnosticKind::TopLevelNodeHasParent: return "top level node has parent";
+        case GraphDiagnosticKind::DuplicateTopLevelNode: return "duplicate top level node";
+        case GraphDiagnosticKind::UnplacedNode: return "unplaced node";
+        case GraphDiagnosticKind::OrphanedElseIf: return "orphaned elif";
+        case GraphDiagnosticKind::OrphanedElse: return "orphaned else";
+        default: return "unknown";
+        }
+    }
+
+    struct GraphDiagnostic
+    {
+        GraphDiagnosticKind m_Kind;
+        BlockNodeHandle m_ID; //the node the problem is on
+        BlockNodeHandle m_RelatedID = {}; //parent, sibling or second parent depending on m_Kind, see GraphDiagnosticKind
+
+        friend constexpr bool operator==(const GraphDiagnostic&, const GraphDiagnostic&) = default;
+    };
+
+    //////////////////////////////////////////////
+    // Graph Validation Report
+    //////////////////////////////////////////////
+
+    struct GraphValidationReport
+    {
+        std::vector<GraphDiagnostic> m_Diagnostics = {}; //sorted by kind then slot index, so the same graph always reports in the same order
+        size_t m_CheckedNodeCount = 0;
+        uint64_t m_GraphRevision = 0; //ExecutionParser revision the report was made at
+
+        [[nodiscard]] bool
+            IsValid()
+            const
+        {
+            return m_Diagnostics.empty();
+        }
+    };
+}
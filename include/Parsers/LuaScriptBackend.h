@@ -0,0 +1,163 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <string_view>
+#include <utility>
+
+#include "BlockNodeEmitters.h"
+
+namespace Princess {
+
+    struct LuaScriptBackend;
+
+    //////////////////////////////////////////////
+    // Lua Emitters
+    //////////////////////////////////////////////
+
+    template<>
+    struct BlockNodeEmitter<LuaScriptBackend, BlockNodeKind::Statement>
+    {
+        static void Emit(ScriptSink& fp_Sink, std::string_view /*fp_Name*/, std::string_view fp_CodeSnippet, unsigned int fp_Depth)
+        {
+            fp_Sink.Indent(fp_Depth).Append(fp_CodeSnippet).Append('\n');
+        }
+    };
+
+    template<>
+    struct BlockNodeEmitter<LuaScriptBackend, BlockNodeKind::VariableDefinition>
+    {
+        static void Emit(ScriptSink& fp_Sink, std::string_view fp_Name, std::string_view fp_CodeSnippet, unsigned int fp_Depth)
+        {
+            fp_Sink.Indent(fp_Depth).Append(fp_Name).Append(" = ").Append(fp_CodeSnippet).Append('\n');
+        }
+    };
+
+    template<>
+    struct BlockNodeEmitter<LuaScriptBackend, BlockNodeKind::FunctionDefinition>
+    {
+        static void Emit(ScriptSink& fp_Sink, std::string_view fp_Name, std::string_view /*fp_CodeSnippet*/, unsigned int fp_Depth)
+        {
+            fp_Sink.Indent(fp_Depth).Append("function ").Append(fp_Name).Append('\n'); //m_Name carries the parameter list, same as for Python's "def"
+        }
+    };
+
+    template<>
+    struct BlockNodeEmitter<LuaScriptBackend, BlockNodeKind::Function> : BlockNodeEmitter<LuaScriptBackend, BlockNodeKind::FunctionDefinition> {};
+
+    template<>
+    struct BlockNodeEmitter<LuaScriptBackend, BlockNodeKind::Dictionary> : BlockNodeEmitter<LuaScriptBackend, BlockNodeKind::VariableDefinition> {}; //both are tables in Lua
+
+    template<>
+    struct BlockNodeEmitter<LuaScriptBackend, BlockNodeKind::List> : BlockNodeEmitter<LuaScriptBackend, BlockNodeKind::VariableDefinition> {};
+
+    template<>
+    struct BlockNodeEmitter<LuaScriptBackend, BlockNodeKind::WhileLoop>
+    {
+        static void Emit(ScriptSink& fp_Sink, std::string_view /*fp_Name*/, std::string_view fp_CodeSnippet, unsigned int fp_Depth)
+        {
+            fp_Sink.Indent(fp_Depth).Append("while ").Append(fp_CodeSnippet).Append(" do\n");
+        }
+    };
+
+    template<>
+    struct BlockNodeEmitter<LuaScriptBackend, BlockNodeKind::ForLoop>
+    {
+        static void Emit(ScriptSink& fp_Sink, std::string_view /*fp_Name*/, std::string_view fp_CodeSnippet, unsigned int fp_Depth)
+        {
+            fp_Sink.Indent(fp_Depth).Append("for ").Append(fp_CodeSnippet).Append(" do\n");
+        }
+    };
+
+    template<>
+    struct BlockNodeEmitter<LuaScriptBackend, BlockNodeKind::ForEach> : BlockNodeEmitter<LuaScriptBackend, BlockNodeKind::ForLoop> {}; //generic for, the snippet carries the "k, v in pairs(t)" part
+
+    template<>
+    struct BlockNodeEmitter<LuaScriptBackend, BlockNodeKind::Break>
+    {
+        static void Emit(ScriptSink& fp_Sink, std::string_view /*fp_Name*/, std::string_view /*fp_CodeSnippet*/, unsigned int fp_Depth)
+        {
+            fp_Sink.Indent(fp_Depth).Append("break\n");
+        }
+    };
+
+    template<>
+    struct BlockNodeEmitter<LuaScriptBackend, BlockNodeKind::If>
+    {
+        static void Emit(ScriptSink& fp_Sink, std::string_view /*fp_Name*/, std::string_view fp_CodeSnippet, unsigned int fp_Depth)
+        {
+            fp_Sink.Indent(fp_Depth).Append("if ").Append(fp_CodeSnippet).Append(" then\n");
+        }
+    };
+
+    template<>
+    struct BlockNodeEmitter<LuaScriptBackend, BlockNodeKind::ElseIf>
+    {
+        static void Emit(ScriptSink& fp_Sink, std::string_view /*fp_Name*/, std::string_view fp_CodeSnippet, unsigned int fp_Depth)
+        {
+            fp_Sink.Indent(fp_Depth).Append("elseif ").Append(fp_CodeSnippet).Append(" then\n");
+        }
+    };
+
+    template<>
+    struct BlockNodeEmitter<LuaScriptBackend, BlockNodeKind::Else>
+    {
+        static void Emit(ScriptSink& fp_Sink, std::string_view /*fp_Name*/, std::string_view /*fp_CodeSnippet*/, unsigned int fp_Depth)
+        {
+            fp_Sink.Indent(fp_Depth).Append("else\n");
+        }
+    };
+
+    //////////////////////////////////////////////
+    // Lua Backend
+    //////////////////////////////////////////////
+
+    struct LuaScriptBackend
+    {
+        static constexpr bool HAS_BLOCK_TERMINATORS = true;
+
+        void
+            EmitBlockOpen(const BlockNodeKind fp_Kind, ScriptSink& fp_Sink, const std::string_view fp_Name, const std::string_view fp_CodeSnippet, const unsigned int fp_Depth)
+            const
+        {
+            DispatchBlockNodeEmitter<LuaScriptBackend>(std::make_index_sequence<BLOCK_NODE_KIND_COUNT>{}, fp_Kind, fp_Sink, fp_Name, fp_CodeSnippet, fp_Depth);
+        }
+
+        void
+            EmitBlockClose(const BlockNodeKind fp_Kind, ScriptSink& fp_Sink, const unsigned int fp_Depth)
+            const
+        {
+            switch (fp_Kind)
+            {
+            case BlockNodeKind::FunctionDefinition: case BlockNodeKind::Function:
+            case BlockNodeKind::WhileLoop: case BlockNodeKind::ForLoop: case BlockNodeKind::ForEach:
+            case BlockNodeKind::If: case BlockNodeKind::ElseIf: case BlockNodeKind::Else:
+                fp_Sink.Indent(fp_Depth).Append("end\n");
+                break;
+
+            default:
+                break;
+            }
+        }
+
+        [[nodiscard]] bool
+            ContinuesBlock(const BlockNodeKind fp_ClosingKind, const BlockNodeKind fp_NextKind) //one "end" for a whole if/elseif/else chain
+            const
+        {
+            return (fp_ClosingKind == BlockNodeKind::If or fp_ClosingKind == BlockNodeKind::ElseIf)
+                and (fp_NextKind == BlockNodeKind::ElseIf or fp_NextKind == BlockNodeKind::Else);
+        }
+    };
+
+    static_assert(BLOCK_NODE_EMITTER_TABLE<LuaScriptBackend>.size() == BLOCK_NODE_KIND_COUNT, "Every BlockNodeKind needs a Lua BlockNodeEmitter specialization");
+
+    inline constexpr LuaScriptBackend LUA_SCRIPT_BACKEND = {};
+}
@@ -6,22 +6,68 @@
 */
 
 //#include "../../Python/PythonScriptComponent.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 
-//#include <pybind11/pybind11.h>
-//#include <pybind11/embed.h> //Use pybind11 to embed Python
+#include <pybind11/pybind11.h>
+#include <pybind11/embed.h> //Use pybind11 to embed Python
 #include <iostream>
 #include <vector>
 
+#include "../Logger.h"
+#include "../SPSCQueue.h"
+#include "ScriptBytecodeCache.h"
+
+#if defined(__GNUG__) && !defined(_WIN32) //pybind11 gives its namespace hidden visibility here, so every type holding a py object has to match
+	#define PRINCESS_PYTHON_HIDDEN __attribute__((visibility("hidden")))
+#else
+	#define PRINCESS_PYTHON_HIDDEN
+#endif
+
 namespace Princess {
 
+	namespace py = pybind11;
+
 	struct PythonFunctionInfo {
 		std::string Name;
 		std::string Info;
 		std::string Module;
 	};
 
-	class PythonScriptParser//PeachCore::PythonScriptComponent fp_Script
+	struct PRINCESS_PYTHON_HIDDEN CompiledPythonScript
+	{
+		py::object m_CodeObject;
+		size_t m_ScriptLength = 0; //cheap extra check on top of the hash before trusting a cached code object
+		uint64_t m_LastUsedRun = 0; //for evicting the least recently run script once the cache is full
+	};
+
+	struct ScriptEvent
+	{
+		enum class Type : unsigned char
+		{
+			Output, //one line the script wrote to sys.stdout
+			ErrorOutput, //one line the script wrote to sys.stderr
+			Finished,
+			Failed, //m_Text holds the Python exception
+			Cancelled,
+			TimedOut
+		};
+
+		uint64_t m_RunID = 0;
+		Type m_Type = Type::Output;
+		std::string m_Text;
+	};
+
+	class PRINCESS_PYTHON_HIDDEN PythonScriptParser//PeachCore::PythonScriptComponent fp_Script
 	{
 	public:
 		static PythonScriptParser& Parser() {
@@ -31,18 +77,88 @@ namespace Princess {
 		};
 
 	public:
-		void ExtractFunctionInformationFromPythonModule(const std::string& fp_DesiredModuleImport);
+		//owned by EditorManager, the interpreter then stays alive until ShutdownInterpreter() instead of being spun up per call.
+		//Compiled scripts also get persisted under fp_BytecodeCacheDirectory in the PhysFS write dir, unless it's empty
+		bool InitializeInterpreter(const std::string& fp_LogOutputDirectory, const std::string& fp_BytecodeCacheDirectory = "");
+		void ShutdownInterpreter();
+		bool IsInterpreterRunning() const;
 
-		void ExecutePythonScript(std::string fp_PythonScript);
+		//Queues a run on the script thread and returns its run ID right away (0 if the interpreter isn't running). The first run of a hash compiles it,
+		//every run after that re-executes the cached code object. A zero fp_Timeout means the script can run for as long as it wants
+		uint64_t SubmitScript(std::string fp_Script, const uint64_t fp_ScriptHash, const std::chrono::milliseconds fp_Timeout = std::chrono::milliseconds::zero());
+
+		bool CancelScript(const uint64_t fp_RunID); //queued runs are dropped, a running script gets a KeyboardInterrupt at its next bytecode boundary
+		bool IsScriptRunning() const;
+
+		size_t PollScriptEvents(const std::function<void(ScriptEvent&)>& fp_Handler, const size_t fp_MaxEvents = 256); //main thread only, never blocks
+		void ClearCompiledScriptCache(); //takes effect before the next run starts, the on-disk bytecode cache is left alone
+
+		void ExtractFunctionInformationFromPythonModule(const std::string& fp_DesiredModuleImport);
 
 		std::vector<PythonFunctionInfo> m_ListOfPythonFunctionsToAutoPopulate = {};
 
 	private:
 		PythonScriptParser() = default;
-		~PythonScriptParser() = default;
+		~PythonScriptParser();
 
 		PythonScriptParser(const PythonScriptParser&) = delete;
 		PythonScriptParser& operator=(const PythonScriptParser&) = delete;
 
+	private:
+		struct PendingScript
+		{
+			uint64_t m_RunID = 0;
+			std::string m_Script;
+			uint64_t m_ScriptHash = 0;
+			std::chrono::milliseconds m_Timeout = std::chrono::milliseconds::zero();
+		};
+
+		//everything below runs on the script thread while holding the GIL
+		ScriptEvent RunScript(const PendingScript& fp_PendingScript);
+		py::object GetCompiledScript(const std::string_view fp_Script, const uint64_t fp_ScriptHash);
+		py::object CompileScript(const std::string_view fp_Script) const;
+		void EvictLeastRecentlyRunScript();
+		void PushScriptEvent(ScriptEvent&& fp_Event);
+
+		void ScriptThreadLoop();
+		void WatchdogThreadLoop(); //raises the KeyboardInterrupt for cancelled and timed out runs, so neither the main thread nor the script thread has to wait on it
+
+	private:
+		static constexpr size_t MAX_COMPILED_SCRIPTS = 32;
+		static constexpr size_t SCRIPT_EVENT_CAPACITY = 1024;
+		static constexpr size_t RESERVED_STATUS_EVENTS = 16; //output stops being queued this close to full so Finished/Failed/etc. always fit
+		static constexpr uint64_t MAX_BYTECODE_CACHE_BYTES = 64ull * 1024 * 1024;
+
+		unique_ptr<Logger> python_logger = nullptr;
+		unique_ptr<py::scoped_interpreter> pm_Interpreter = nullptr; //declared before the cache so the code objects get released while the interpreter is still alive
+		unique_ptr<py::gil_scoped_release> pm_MainThreadGILRelease = nullptr; //the main thread gives the GIL up for as long as the script thread exists
+
+		std::unordered_map<uint64_t, CompiledPythonScript> pm_CompiledScripts = {}; //keyed by HashScript() of the generated source, script thread only
+		uint64_t pm_RunCount = 0;
+		std::atomic<bool> pm_ShouldClearCompiledScripts = false;
+		ScriptBytecodeCache pm_BytecodeCache; //second level under pm_CompiledScripts, script thread only once it's running
+
+		//////////////////// Script Thread ////////////////////
+
+		std::thread pm_ScriptThread;
+		std::thread pm_WatchdogThread;
+
+		mutable std::mutex pm_ScriptMutex; //guards everything down to pm_InterruptReason, never held while waiting on the GIL
+		std::condition_variable pm_ScriptQueued;
+		std::condition_variable pm_WatchdogWake;
+
+		std::deque<PendingScript> pm_PendingScripts = {};
+		uint64_t pm_NextRunID = 1;
+
+		uint64_t pm_RunningRunID = 0; //0 while idle
+		unsigned long pm_RunningPythonThreadID = 0;
+		std::chrono::steady_clock::time_point pm_RunningDeadline = std::chrono::steady_clock::time_point::max();
+		uint64_t pm_CancelledRunID = 0;
+		ScriptEvent::Type pm_InterruptReason = ScriptEvent::Type::Finished; //Cancelled or TimedOut once the watchdog has interrupted the running script
+
+		std::atomic<bool> pm_IsStopping = false;
+
+		SPSCQueue<ScriptEvent, SCRIPT_EVENT_CAPACITY> pm_ScriptEvents; //every push happens with the GIL held, which is what keeps it single producer
+		size_t pm_DroppedOutputLines = 0;
 	};
 }
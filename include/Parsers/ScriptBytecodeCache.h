@@ -0,0 +1,102 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <pybind11/pybind11.h>
+#include <physfs.h>
+
+#include "../Logger.h"
+
+namespace Princess {
+
+    namespace py = pybind11;
+
+    //////////////////////////////////////////////
+    // Script Bytecode Cache
+    //////////////////////////////////////////////
+    /*
+    Persists compiled generated scripts as marshalled code objects under a directory in the PhysFS write dir, so reopening a project after a
+    restart runs straight off the bytecode instead of compiling again. Entries are content addressed by the generated source hash mixed with
+    the interpreter's cache tag and bytecode magic number, so a Python upgrade just misses instead of loading bytecode it can't run.
+    The directory is kept under a byte budget by evicting the least recently used entries, recency survives restarts through a small index file.
+    Only ever touched from the script thread with the GIL held.
+    */
+
+    class ScriptBytecodeCache
+    {
+    public:
+        ScriptBytecodeCache() = default;
+        ~ScriptBytecodeCache() = default;
+
+        ScriptBytecodeCache(const ScriptBytecodeCache&) = delete;
+        ScriptBytecodeCache& operator=(const ScriptBytecodeCache&) = delete;
+
+    public:
+        bool Open(const std::string& fp_CacheDirectory, const uint64_t fp_MaxCacheBytes, Logger* fp_Logger); //needs the GIL and PhysFS with a write dir already set
+        void Close(); //writes the recency index back out, safe to call when it was never opened
+
+        bool IsOpen() const;
+
+        //empty py::object on a miss, or when the entry on disk turned out to be for a different source/interpreter (it gets deleted)
+        py::object Load(const std::string_view fp_Script, const uint64_t fp_ScriptHash);
+        void Store(const std::string_view fp_Script, const uint64_t fp_ScriptHash, const py::object& fp_CodeObject);
+
+        void Clear(); //deletes every entry, the directory itself stays
+
+        uint64_t GetCacheBytes() const;
+        size_t GetEntryCount() const;
+
+    private:
+        struct CacheEntry
+        {
+            uint64_t m_FileBytes = 0;
+            uint64_t m_LastUsed = 0; //microseconds since the unix epoch, only used for ordering evictions
+        };
+
+        struct EntryHeader //written in front of the marshal data, checked before trusting any of it
+        {
+            char m_Magic[4] = { 'P', 'S', 'B', 'C' };
+            uint32_t m_FormatVersion = 1;
+            uint64_t m_InterpreterTag = 0;
+            uint64_t m_ScriptHash = 0;
+            uint64_t m_ScriptLength = 0;
+        };
+
+        uint64_t GetEntryKey(const uint64_t fp_ScriptHash) const;
+        std::string GetEntryPath(const uint64_t fp_EntryKey) const;
+
+        void LoadIndex();
+        void SaveIndex() const;
+        void RemoveEntry(const uint64_t fp_EntryKey);
+        void EvictUntilUnderBudget();
+
+        void LogWarning(const std::string& fp_Message) const;
+
+    private:
+        static constexpr std::string_view ENTRY_EXTENSION = ".psbc";
+        static constexpr std::string_view INDEX_FILE_NAME = "index.txt";
+
+        Logger* pm_Logger = nullptr; //owned by PythonScriptParser
+
+        bool pm_IsOpen = false;
+        std::string pm_CacheDirectory = "";
+        uint64_t pm_MaxCacheBytes = 0;
+        uint64_t pm_InterpreterTag = 0; //hash of sys.implementation.cache_tag + importlib's MAGIC_NUMBER
+
+        std::unordered_map<uint64_t, CacheEntry> pm_Entries = {}; //keyed by GetEntryKey(), mirrors what's on disk
+        uint64_t pm_CacheBytes = 0;
+    };
+}
@@ -0,0 +1,49 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace Princess {
+
+    //////////////////////////////////////////////
+    // Script Hashing
+    //////////////////////////////////////////////
+
+    inline constexpr uint64_t SCRIPT_HASH_SEED = 0xcbf29ce484222325ull; //FNV-1a 64 offset basis
+
+    //FNV-1a, not cryptographic, only used to key caches of generated scripts. Pass a previous result as fp_Seed to hash several pieces as one
+    [[nodiscard]] constexpr uint64_t
+        HashScript(const std::string_view fp_Script, uint64_t fp_Seed = SCRIPT_HASH_SEED)
+    {
+        for (const char l_Character : fp_Script)
+        {
+            fp_Seed ^= static_cast<unsigned char>(l_Character);
+            fp_Seed *= 0x100000001b3ull;
+        }
+
+        return fp_Seed;
+    }
+
+    //Order dependent mix of an already hashed value into fp_Seed, for hashes built out of other hashes (eg. a node out of its children's)
+    [[nodiscard]] constexpr uint64_t
+        CombineHashes(const uint64_t fp_Seed, const uint64_t fp_Value)
+    {
+        uint64_t f_Hash = fp_Seed ^ (fp_Value + 0x9e3779b97f4a7c15ull + (fp_Seed << 6) + (fp_Seed >> 2));
+
+        f_Hash ^= f_Hash >> 33; //murmur3 finalizer, so child hashes that only differ in a few bits still spread over the whole word
+        f_Hash *= 0xff51afd7ed558ccdull;
+        f_Hash ^= f_Hash >> 33;
+
+        return f_Hash;
+    }
+}
@@ -0,0 +1,126 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "FlattenedBlockNodeTree.h"
+
+namespace Princess {
+
+    //////////////////////////////////////////////
+    // Optimization Passes
+    //////////////////////////////////////////////
+
+    enum class ScriptOptimizationPasses : uint32_t
+    {
+        None = 0,
+        FoldConstantConditions = 1u << 0, //literal if/elif/while conditions (0, '', None, not 1, (True)...) get written as True/False
+        EliminateDeadBranches = 1u << 1, //if/elif/while False, the untaken rest of an if True chain and whatever follows a break
+        RemoveEmptyElse = 1u << 2,
+        MergeVariableDefinitions = 1u << 3, //runs of literal assignments become one tuple assignment, overwritten ones get dropped
+        All = FoldConstantConditions | EliminateDeadBranches | RemoveEmptyElse | MergeVariableDefinitions
+    };
+
+    constexpr ScriptOptimizationPasses
+        operator|(const ScriptOptimizationPasses fp_Left, const ScriptOptimizationPasses fp_Right)
+    {
+        return static_cast<ScriptOptimizationPasses>(static_cast<uint32_t>(fp_Left) | static_cast<uint32_t>(fp_Right));
+    }
+
+    constexpr bool
+        HasScriptOptimizationPass(const ScriptOptimizationPasses fp_Passes, const ScriptOptimizationPasses fp_Pass)
+    {
+        return (static_cast<uint32_t>(fp_Passes) & static_cast<uint32_t>(fp_Pass)) != 0;
+    }
+
+    //////////////////////////////////////////////
+    // Script Optimizer
+    //////////////////////////////////////////////
+    /*
+    Rewrites a flattened snapshot into a smaller one right before emission, the graph the user edits is never touched. Every pass runs
+    in the same linear scan over the snapshot: dropped subtrees get skipped using m_SubtreeSize, branches that always run (if True, the
+    else of an all False chain) get hoisted by writing their children one level up, and blocks that lost their whole body get a pass so
+    the output still compiles. Entries keep the m_ID of the node they came from, so source maps built from the result still point into
+    the graph (merged definitions point at the first one of the run).
+    Only literals get evaluated, anything that could have side effects or depends on a name is left exactly as the user wrote it.
+    */
+
+    class ScriptOptimizer
+    {
+    public:
+        enum class ConstantCondition : unsigned char
+        {
+            Unknown,
+            False,
+            True
+        };
+
+    public:
+        const FlattenedBlockNodeTree& Optimize(const FlattenedBlockNodeTree& fp_Snapshot, const ScriptOptimizationPasses fp_Passes); //the result stays valid until the next call
+
+        size_t GetRemovedNodeCount() const; //snapshot entries that didn't make it into the last result, merged ones included
+
+        static ConstantCondition EvaluateConstantCondition(std::string_view fp_Condition);
+        static bool IsLiteralExpression(std::string_view fp_Expression); //numbers, plain string literals, True/False/None
+
+    private:
+        enum class ChainState : unsigned char
+        {
+            None, //no if chain open at this level
+            Open, //the last chain member got written, elif/else attach to it as usual
+            AllFalse, //every member so far was dropped, the next elif becomes an if and an else gets hoisted
+            Taken //a member that always runs was written, the rest of the chain is unreachable
+        };
+
+        struct OpenLevel //one per snapshot entry whose subtree is still being scanned
+        {
+            uint32_t m_InputDepth;
+            uint32_t m_OutputEntry; //index into pm_Output.m_Nodes, unused when hoisted
+            uint32_t m_ChildDepth; //depth the children get written at
+            uint32_t m_OutputChildCount = 0;
+            bool m_HadChildren = false;
+            bool m_IsHoisted = false;
+            bool m_IsUnreachable = false; //a break was written, later siblings never run
+            ChainState m_Chain = ChainState::None;
+        };
+
+        void CloseLevel();
+        void WriteEntry(const FlattenedBlockNode& fp_Entry, const BlockNodeKind fp_Kind, const ConstantCondition fp_Condition);
+        void HoistEntry(const FlattenedBlockNode& fp_Entry);
+        void DropSubtree(const uint32_t fp_Index);
+
+        uint32_t MergeVariableDefinitions(const uint32_t fp_Index); //returns how many snapshot entries the run consumed, 0 when there's nothing to merge
+        bool IsMergeableDefinition(const FlattenedBlockNode& fp_Entry) const;
+
+        uint32_t AppendToPool(const std::string_view fp_Text);
+        bool HasPass(const ScriptOptimizationPasses fp_Pass) const;
+
+    private:
+        static constexpr uint32_t MAX_MERGED_DEFINITIONS = 32; //keeps merged lines readable and the duplicate check cheap
+
+        ScriptOptimizationPasses pm_Passes = ScriptOptimizationPasses::None;
+        const FlattenedBlockNodeTree* pm_Input = nullptr;
+
+        FlattenedBlockNodeTree pm_Output;
+        std::vector<OpenLevel> pm_OpenLevels = {};
+        std::vector<uint32_t> pm_MergedDefinitions = {}; //scratch for MergeVariableDefinitions()
+        std::vector<uint32_t> pm_OpenOutputEntries = {}; //scratch for recomputing m_SubtreeSize once the scan is done
+
+        uint32_t pm_PassOffset = UINT32_MAX; //"pass", "True" and "False" get appended to the output pool the first time they're needed
+        uint32_t pm_TrueOffset = UINT32_MAX;
+        uint32_t pm_FalseOffset = UINT32_MAX;
+
+        size_t pm_RemovedNodeCount = 0;
+    };
+}
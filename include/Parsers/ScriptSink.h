@@ -0,0 +1,115 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <array>
+#include <string>
+#include <string_view>
+
+namespace Princess {
+
+    //////////////////////////////////////////////
+    // Script Output Sink
+    //////////////////////////////////////////////
+    /*
+    Output buffer that BlockNodes emit straight into during codegen. Indentation is copied out of a precomputed table instead of building a
+    fresh std::string per node, and Clear() keeps the capacity around, so once the buffer has grown to fit a graph, regenerating that graph
+    doesn't allocate at all.
+    */
+
+    class ScriptSink
+    {
+    public:
+        static constexpr size_t SPACES_PER_INDENT = 4;
+
+    public:
+        ScriptSink() = default;
+
+        explicit ScriptSink(const size_t fp_ReservedBytes)
+        {
+            pm_Buffer.reserve(fp_ReservedBytes);
+        }
+
+    public:
+        ScriptSink&
+            Indent(const unsigned int fp_Depth)
+        {
+            size_t f_Remaining = fp_Depth * SPACES_PER_INDENT;
+
+            while (f_Remaining > 0) //only loops more than once for absurdly deep nesting
+            {
+                const size_t f_Chunk = f_Remaining < INDENT_TABLE.size() ? f_Remaining : INDENT_TABLE.size();
+                pm_Buffer.append(INDENT_TABLE.data(), f_Chunk);
+                f_Remaining -= f_Chunk;
+            }
+
+            return *this;
+        }
+
+        ScriptSink&
+            Append(const std::string_view fp_Text)
+        {
+            pm_Buffer.append(fp_Text);
+            return *this;
+        }
+
+        ScriptSink&
+            Append(const char fp_Character)
+        {
+            pm_Buffer.push_back(fp_Character);
+            return *this;
+        }
+
+        void
+            Reserve(const size_t fp_Bytes)
+        {
+            pm_Buffer.reserve(fp_Bytes);
+        }
+
+        void
+            Clear() //keeps the capacity for the next run
+        {
+            pm_Buffer.clear();
+        }
+
+        [[nodiscard]] size_t
+            Size()
+            const
+        {
+            return pm_Buffer.size();
+        }
+
+        [[nodiscard]] std::string_view
+            View()
+            const
+        {
+            return pm_Buffer;
+        }
+
+        [[nodiscard]] std::string
+            TakeScript() //moves the buffer out, the sink is empty afterwards
+        {
+            std::string f_Script = std::move(pm_Buffer);
+            pm_Buffer.clear();
+            return f_Script;
+        }
+
+    private:
+        static constexpr std::array<char, 64 * SPACES_PER_INDENT> INDENT_TABLE = []
+        {
+            std::array<char, 64 * SPACES_PER_INDENT> f_Table{};
+            f_Table.fill(' ');
+            return f_Table;
+        }();
+
+        std::string pm_Buffer;
+    };
+}
@@ -0,0 +1,175 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "../SlotMap.h"
+
+namespace Princess {
+
+    //////////////////////////////////////////////
+    // Source Map Entry
+    //////////////////////////////////////////////
+
+    struct ScriptSourceMapEntry
+    {
+        uint32_t m_FirstLine; //0-based, the node owns every line up to the next entry's m_FirstLine
+        SlotHandle m_ID; //BlockNodeHandle of the node that emitted the line
+    };
+
+    //////////////////////////////////////////////
+    // Script Source Map
+    //////////////////////////////////////////////
+    /*
+    Sorted line interval table from generated script lines back to the BlockNodes that emitted them, one entry per node in emission
+    (preorder) order, so it comes out sorted for free. Codegen fills it as a by-product and splices clean subtrees out of the previous
+    map the same way it splices their text, so tracebacks, profiler samples and error markers get resolved with a binary search instead
+    of regenerating or rescanning the script.
+    */
+
+    class ScriptSourceMap
+    {
+    public:
+        void
+            Append(const uint32_t fp_FirstLine, const SlotHandle fp_ID)
+        {
+            pm_Entries.push_back({ fp_FirstLine, fp_ID });
+        }
+
+        void
+            AppendShifted(const ScriptSourceMap& fp_Other, const size_t fp_FirstEntry, const size_t fp_EntryCount, const uint32_t fp_FirstLine) //copies a run of fp_Other's entries so the first one starts at fp_FirstLine
+        {
+            if (fp_EntryCount == 0) { return; }
+
+            const uint32_t f_OldFirstLine = fp_Other.pm_Entries[fp_FirstEntry].m_FirstLine;
+
+            if (fp_EntryCount == 1) //clean leaves, by far the most common subtree that gets copied
+            {
+                pm_Entries.push_back({ fp_FirstLine, fp_Other.pm_Entries[fp_FirstEntry].m_ID });
+                return;
+            }
+            const size_t f_Start = pm_Entries.size();
+
+            pm_Entries.insert(pm_Entries.end(), fp_Other.pm_Entries.begin() + fp_FirstEntry, fp_Other.pm_Entries.begin() + fp_FirstEntry + fp_EntryCount);
+
+            if (f_OldFirstLine == fp_FirstLine) //usual case when only something after the subtree changed
+            {
+                return;
+            }
+
+            for (size_t l_Index = f_Start; l_Index < pm_Entries.size(); l_Index++)
+            {
+                pm_Entries[l_Index].m_FirstLine = pm_Entries[l_Index].m_FirstLine - f_OldFirstLine + fp_FirstLine;
+            }
+        }
+
+        template<typename Function>
+        void
+            AssignRemapped(const ScriptSourceMap& fp_Other, Function&& fp_RemapID) //copy of fp_Other with every m_ID run through fp_RemapID, for text that got copied over to other nodes
+        {
+            pm_Entries.resize(fp_Other.pm_Entries.size());
+
+            for (size_t l_Index = 0; l_Index < pm_Entries.size(); l_Index++)
+            {
+                pm_Entries[l_Index] = { fp_Other.pm_Entries[l_Index].m_FirstLine, fp_RemapID(fp_Other.pm_Entries[l_Index].m_ID) };
+            }
+
+            pm_LineCount = fp_Other.pm_LineCount;
+        }
+
+        //1-based like Python tracebacks, returns the node whose text starts on that line (or the one the line is in the middle of), null handle if nothing was emitted there
+        [[nodiscard]] SlotHandle
+            FindBlockNodeAtLine(const uint32_t fp_LineNumber)
+            const
+        {
+            if (fp_LineNumber == 0 or pm_Entries.empty() or fp_LineNumber > pm_LineCount) { return {}; }
+
+            const uint32_t f_Line = fp_LineNumber - 1;
+
+            const auto f_Entry = std::lower_bound
+            (
+                pm_Entries.begin(), pm_Entries.end(), f_Line,
+                [](const ScriptSourceMapEntry& fp_Entry, const uint32_t fp_Line)
+                {
+                    return fp_Entry.m_FirstLine < fp_Line;
+                }
+            );
+
+            if (f_Entry != pm_Entries.end() and f_Entry->m_FirstLine == f_Line) //nodes without a trailing newline share their line with the next one, the first one on the line wins
+            {
+                return f_Entry->m_ID;
+            }
+
+            return f_Entry == pm_Entries.begin() ? SlotHandle{} : std::prev(f_Entry)->m_ID;
+        }
+
+        void
+            SetLineCount(const uint32_t fp_LineCount) //lines past this aren't part of the script, set once emission is done
+        {
+            pm_LineCount = fp_LineCount;
+        }
+
+        void
+            Reserve(const size_t fp_EntryCount)
+        {
+            pm_Entries.reserve(fp_EntryCount);
+        }
+
+        void
+            Clear() //keeps the capacity for the next run
+        {
+            pm_Entries.clear();
+            pm_LineCount = 0;
+        }
+
+        void
+            Swap(ScriptSourceMap& fp_Other)
+        {
+            pm_Entries.swap(fp_Other.pm_Entries);
+            std::swap(pm_LineCount, fp_Other.pm_LineCount);
+        }
+
+        [[nodiscard]] const ScriptSourceMapEntry&
+            operator[](const size_t fp_Index)
+            const
+        {
+            return pm_Entries[fp_Index];
+        }
+
+        [[nodiscard]] size_t
+            Size()
+            const
+        {
+            return pm_Entries.size();
+        }
+
+        [[nodiscard]] uint32_t
+            GetLineCount()
+            const
+        {
+            return pm_LineCount;
+        }
+
+        [[nodiscard]] const std::vector<ScriptSourceMapEntry>&
+            GetEntries()
+            const
+        {
+            return pm_Entries;
+        }
+
+    private:
+        std::vector<ScriptSourceMapEntry> pm_Entries = {};
+        uint32_t pm_LineCount = 0;
+    };
+}
@@ -0,0 +1,95 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace Princess {
+
+    //////////////////////////////////////////////
+    // Single Producer Single Consumer Queue
+    //////////////////////////////////////////////
+    /*
+    Bounded lock-free ring buffer for handing results from one background thread to the main thread without either side ever blocking.
+    Exactly one thread may push and exactly one thread may pop at any given time (whatever serializes the producers, eg. the GIL, has to
+    also give a happens-before between them). Head and tail live on separate cache lines so the two sides don't false share.
+    */
+
+    template<typename T, size_t CAPACITY>
+    class SPSCQueue
+    {
+        static_assert(CAPACITY >= 2 and (CAPACITY & (CAPACITY - 1)) == 0, "SPSCQueue capacity has to be a power of two");
+
+    public:
+        SPSCQueue() = default;
+
+        SPSCQueue(const SPSCQueue&) = delete;
+        SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    public:
+        [[nodiscard]] bool
+            TryPush(T&& fp_Value) //producer only, false when full
+        {
+            const size_t f_Tail = pm_Tail.load(std::memory_order_relaxed);
+
+            if (f_Tail - pm_Head.load(std::memory_order_acquire) == CAPACITY)
+            {
+                return false;
+            }
+
+            pm_Slots[f_Tail & (CAPACITY - 1)] = std::move(fp_Value);
+            pm_Tail.store(f_Tail + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        [[nodiscard]] std::optional<T>
+            TryPop() //consumer only, empty when there is nothing to read
+        {
+            const size_t f_Head = pm_Head.load(std::memory_order_relaxed);
+
+            if (f_Head == pm_Tail.load(std::memory_order_acquire))
+            {
+                return std::nullopt;
+            }
+
+            std::optional<T> f_Value = std::move(pm_Slots[f_Head & (CAPACITY - 1)]);
+            pm_Head.store(f_Head + 1, std::memory_order_release);
+
+            return f_Value;
+        }
+
+        [[nodiscard]] size_t
+            ApproximateSize() //exact from either side's own point of view, a snapshot for everyone else
+            const
+        {
+            return pm_Tail.load(std::memory_order_acquire) - pm_Head.load(std::memory_order_acquire);
+        }
+
+        static constexpr size_t
+            Capacity()
+        {
+            return CAPACITY;
+        }
+
+    private:
+        static constexpr size_t CACHE_LINE_SIZE = 64;
+
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> pm_Head = 0; //next slot to pop, only the consumer writes this
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> pm_Tail = 0; //next slot to push, only the producer writes this
+
+        alignas(CACHE_LINE_SIZE) std::array<T, CAPACITY> pm_Slots = {};
+    };
+}
@@ -13,11 +13,16 @@
 ///STL
 #include <algorithm>
 #include <cctype>
+#include <charconv>
+#include <map>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 ///Princess
-#include "LogManager.h"
+#include "Logger.h"
+#include "JSONLexer.h"
+#include "SourceFile.h"
 
 
 /// Magic
@@ -49,32 +54,44 @@ namespace Princess {
 			(
 				T& fp_DesiredObject,
 				const string& fp_FilePath,
-				LogManager* logger
+				Logger* logger
 			)
 		{
-			string f_JsonString;
-			vector<Token> f_TokenizedJson;
+			SourceFile f_JsonFile;
 
-			JSONValue f_TempJSON;
-
-			if (not ReadJSONIntoString(fp_FilePath, &f_JsonString, logger)) //get JSON into a string
+			if (not OpenJSONFile(fp_FilePath, f_JsonFile, logger)) //mapped when it can be, the parser reads straight out of the file's pages
 			{
-				logger->LogAndPrint("Failed to Read JSON", "FromJSON", LogManager::LogLevel::Error);
+				logger->LogAndPrint("Failed to Read JSON", "FromJSON", Logger::LogLevel::Error);
 				return false;
 			}
-			else if (not Tokenize(f_TokenizedJson, f_JsonString, logger)) //convert JSON string into a vector of tokens
+			else if (not FromJSONString(fp_DesiredObject, f_JsonFile.GetContents(), logger))
 			{
-				logger->LogAndPrint("Failed to Lex JSON", "FromJSON", LogManager::LogLevel::Error);
+				logger->LogAndPrint(format("Failed to retrieve data values from desired JSON file: {}", fp_FilePath), "FromJSON", Logger::LogLevel::Error);
 				return false;
 			}
-			else if (not ParseJSON(f_TokenizedJson, f_TempJSON, logger)) //parse the tokens into a valid JSONValue object
+
+			return true;
+		}
+
+		template<typename T>
+		bool
+			FromJSONString
+			(
+				T& fp_DesiredObject,
+				const string_view fp_JsonString, //only has to live until this returns, nothing in fp_DesiredObject points back into it
+				Logger* logger
+			)
+		{
+			JSONValue f_TempJSON;
+
+			if (not ParseJSON(fp_JsonString, f_TempJSON, logger)) //lex and parse the JSON into a valid JSONValue object in a single pass
 			{
-				logger->LogAndPrint("Failed to Parse JSON", "FromJSON", LogManager::LogLevel::Error);
+				logger->LogAndPrint("Failed to Parse JSON", "FromJSONString", Logger::LogLevel::Error);
 				return false;
 			}
 			else if (not FromJSON(f_TempJSON, fp_DesiredObject)) //retrieve values and insert into fp_DesiredObject
 			{
-				logger->LogAndPrint(format("Failed to retrieve data values from desired JSON file: {}", fp_FilePath), "FromJSON", LogManager::LogLevel::Error);
+				logger->LogAndPrint("Failed to retrieve data values from JSON", "FromJSONString", Logger::LogLevel::Error);
 				return false;
 			}
 
@@ -88,14 +105,14 @@ namespace Princess {
 				T& fp_DesiredObject,
 				const string& fp_DesiredFileName,
 				const string& fp_DesiredOutputDirectory,
-				LogManager* logger
+				Logger* logger
 			)
 		{
 			JSONValue f_TempJSON = ToJSON(fp_DesiredObject);
 
 			if (not WriteToJSON(fp_DesiredOutputDirectory, fp_DesiredFileName, f_TempJSON, logger))
 			{
-				logger->LogAndPrint(format("Failed writing to JSON file: {}, nothing was done", fp_DesiredFileName), "ToJSON", LogManager::LogLevel::Error);
+				logger->LogAndPrint(format("Failed writing to JSON file: {}, nothing was done", fp_DesiredFileName), "ToJSON", Logger::LogLevel::Error);
 				return false;
 			}
 
@@ -107,318 +124,8 @@ namespace Princess {
 		// Token and Token-type Definition for JSON
 		//////////////////////////////////////////////
 
-		enum class TokenType
-		{
-			//////////////////// GOATS ////////////////////
-
-			IntLiteral,
-			FloatLiteral,
-			StringLiteral,
-			NullLiteral,
-			BoolLiteral,
-
-			//////////////////// Bracket Types ////////////////////
-
-			OpenBracket,
-			CloseBracket,
-
-			OpenSquareBracket,
-			CloseSquareBracket,
-
-			//////////////////// Symbols ////////////////////
-
-			DoubleDot, // ':'
-			Comma,
-
-			//////////////////// End Of File ////////////////////
-
-			ENDF
-		};
-
-		struct Token
-		{
-			string m_Value;
-			TokenType m_Type;
-			int m_SourceCodeLineNumber;
-
-			explicit Token(const string& fp_Value, const TokenType fp_Type, const int fp_SourceCodeLineNumber)
-			{
-				m_Value = fp_Value;
-				m_Type = fp_Type;
-				m_SourceCodeLineNumber = fp_SourceCodeLineNumber;
-			}
-
-			explicit Token(const char& fp_Value, const TokenType fp_Type, const int fp_SourceCodeLineNumber)
-			{
-				m_Value = fp_Value;
-				m_Type = fp_Type;
-				m_SourceCodeLineNumber = fp_SourceCodeLineNumber;
-			}
-		};
-
-		//////////////////////////////////////////////
-		// Utility Function for Tokenizing JSON
-		//////////////////////////////////////////////
-
-		[[nodiscard]] char
-			ShiftForward(string & fp_Src)
-		{
-			if (fp_Src.empty())
-			{
-				return '\0';
-			}
-
-			char _c = fp_Src[0];
-			fp_Src.erase(fp_Src.begin());
-
-			return _c;
-		}
-
-		//////////////////////////////////////////////
-		// Tokenize Function
-		//////////////////////////////////////////////
-
-		bool
-			Tokenize
-			(
-				vector<Token>& fp_Tokens,
-				string& fp_SourceCode,
-				LogManager* logger
-			)
-		{
-			size_t f_CurrentLineNumber = 1;
-
-			char f_CurrentChar;
-
-			bool f_ShouldShift = true;
-			bool f_IsCurrentlyInsideComment = false;
-
-			while (fp_SourceCode.size() > 0)
-			{
-				//////////////////// Iterate Current Character ////////////////////
-
-				if (f_ShouldShift)
-				{
-					f_CurrentChar = ShiftForward(fp_SourceCode);
-				}
-				else
-				{
-					f_ShouldShift = true; //reset , only triggered for once loop iteration since while loops always step one character over their functioning bounds
-				}
-
-				//////////////////// Handle Spaces, New-Lines, and Comments ////////////////////
-
-				if (f_CurrentChar == '\n') //used to keep track of what line number we're at in the source code, we only have single line comments, so this is sufficient
-				{
-					f_IsCurrentlyInsideComment = false;
-					f_CurrentLineNumber++;
-					continue; //we can shift forwards confidently since we're currently on the newline character
-				}
-				else if (f_IsCurrentlyInsideComment or isspace(f_CurrentChar))
-				{
-					continue;
-				}
-
-				//////////////////// Handle Digits or Alphabetic Characters ////////////////////
-
-				if (isdigit(f_CurrentChar) or f_CurrentChar == '-') //used for finding floats and ints defined inside the JSON
-				{
-					string f_Number; // >w<
-
-					if (f_CurrentChar == '-')
-					{
-						f_Number += '-';
-						f_CurrentChar = ShiftForward(fp_SourceCode);
-
-						if (not isdigit(f_CurrentChar))
-						{
-							logger->LogAndPrint(format("Unexpected symbol following character: '-', looks like you've input a non-numeric symbol: '{}' while defining a negative number at line number: {}", f_CurrentChar, f_CurrentLineNumber), "Lexer", LogManager::LogLevel::Error);
-							fp_SourceCode.clear(); //dump the source code vector, so that the compiler will stop processing the source code
-							return false;
-						}
-					}
-
-					while (fp_SourceCode.size() > 0 and isdigit(f_CurrentChar))
-					{
-						f_Number += f_CurrentChar;
-						f_CurrentChar = ShiftForward(fp_SourceCode); //shift to next character
-					}
-
-					if (f_CurrentChar == '.') //used for handling decimal numbers eg. "let x->float = 3.14;"
-					{
-						f_Number += f_CurrentChar; //add the decimal so we're at: "69. (rest to be parsed)" currently
-						f_CurrentChar = ShiftForward(fp_SourceCode); //shift to next character
-
-						if (not isdigit(f_CurrentChar))
-						{
-							logger->LogAndPrint(format("Unexpected symbol following a '.' brother!, looks like you've input a non-numeric symbol: '{}' while defining a decimal number at line number: {}", f_CurrentChar, f_CurrentLineNumber), "Lexer", LogManager::LogLevel::Error);
-							fp_SourceCode.clear(); //dump the source code vector, so that the compiler will stop processing the source code
-							return false;
-						}
-
-						while (fp_SourceCode.size() > 0 and isdigit(f_CurrentChar))
-						{
-							f_Number += f_CurrentChar;
-							f_CurrentChar = ShiftForward(fp_SourceCode); //shift to next character
-						}
-						//push a float
-						fp_Tokens.emplace_back(f_Number, TokenType::FloatLiteral, f_CurrentLineNumber); //No need for a continue here since the current character isnt a digit
-					}
-					else
-					{	//push an int
-						fp_Tokens.emplace_back(f_Number, TokenType::IntLiteral, f_CurrentLineNumber); //No need for a continue here since the current character isnt a digit
-					}
-
-					f_ShouldShift = false; //ensures we don't skip any crucial branch-logic for the over-stepped character
-					continue; //move to next iteration
-				}
-				else if (isalpha(f_CurrentChar)) //used for finding bools and null literals inside the JSON
-				{
-					string f_Identifier; //start with NOTHING
-
-					while (fp_SourceCode.size() > 0 and isalpha(f_CurrentChar))
-					{
-						f_Identifier += f_CurrentChar;
-						f_CurrentChar = ShiftForward(fp_SourceCode); //shift to next character, this will overstep a character as an exit condition for the while-loop
-					}
-
-					if (f_Identifier == "true" or f_Identifier == "false")
-					{
-						fp_Tokens.emplace_back(f_Identifier, TokenType::BoolLiteral, f_CurrentLineNumber);
-					}
-					else if (f_Identifier == "null")
-					{
-						fp_Tokens.emplace_back(f_Identifier, TokenType::NullLiteral, f_CurrentLineNumber);
-					}
-					else
-					{
-						logger->LogAndPrint(format("Lexing Error: Invalid JSON identifier: '{}', found at line number: {}", f_Identifier, f_CurrentLineNumber), "Lexer", LogManager::LogLevel::Error);
-						fp_SourceCode.clear();
-						return false;
-					}
-
-					f_ShouldShift = false; //ensures we don't skip any crucial branch-logic for the over-stepped character
-					continue; //move to next iteration since
-				}
-
-				switch (f_CurrentChar)
-				{
-				case ':':
-					fp_Tokens.emplace_back(f_CurrentChar, TokenType::DoubleDot, f_CurrentLineNumber);
-					break;
-				case ',':
-					fp_Tokens.emplace_back(f_CurrentChar, TokenType::Comma, f_CurrentLineNumber);
-					break;
-
-				case '{':
-					fp_Tokens.emplace_back(f_CurrentChar, TokenType::OpenBracket, f_CurrentLineNumber);
-					break;
-				case '}':
-					fp_Tokens.emplace_back(f_CurrentChar, TokenType::CloseBracket, f_CurrentLineNumber);
-					break;
-
-				case '[':
-					fp_Tokens.emplace_back(f_CurrentChar, TokenType::OpenSquareBracket, f_CurrentLineNumber);
-					break;
-				case ']':
-					fp_Tokens.emplace_back(f_CurrentChar, TokenType::CloseSquareBracket, f_CurrentLineNumber);
-					break;
-
-				case '.':
-				{
-					f_CurrentChar = ShiftForward(fp_SourceCode); //shift forward and look for a number definition
-
-					if (not isdigit(f_CurrentChar))
-					{
-						logger->LogAndPrint(format("Lexing Error: Invalid JSON identifier: '{}', found at line number: {}", f_CurrentChar, f_CurrentLineNumber), "Lexer", LogManager::LogLevel::Error);
-						fp_SourceCode.clear();
-						return false;
-					}
-
-					string f_Number = "0."; // >w<
-
-					while (fp_SourceCode.size() > 0 and isdigit(f_CurrentChar))
-					{
-						f_Number += f_CurrentChar;
-						f_CurrentChar = ShiftForward(fp_SourceCode); //shift to next character
-					}
-
-					fp_Tokens.emplace_back(f_Number, TokenType::FloatLiteral, f_CurrentLineNumber); //push a float
-				}
-				f_ShouldShift = false; //ensures we don't skip any crucial branch-logic for the over-stepped character
-				break;
-
-				case '"': //VERY IMPORTANT THAT WE PROCESS THIS BEFORE '/' otherwise '/' mentioned inside of strings might be ignored
-				{
-					string f_CurrentStringLiteral = "";
-
-					// Shift to the next character to start capturing the string, not the opening quote
-					f_CurrentChar = ShiftForward(fp_SourceCode);
-
-					bool f_IsEscapeCharacter = false;
-
-					while (fp_SourceCode.size() > 0 and f_CurrentChar != '"')
-					{
-						if (f_CurrentChar == '\\')
-						{
-							f_CurrentChar = ShiftForward(fp_SourceCode); //shift to next character
-
-							switch (f_CurrentChar)
-							{
-								case 'n':
-									f_CurrentStringLiteral += '\n'; // Add a newline character
-									break;
-								case 't':
-									f_CurrentStringLiteral += '\t'; // Add a tab character
-									break;
-								case '\\':
-									f_CurrentStringLiteral += '\\'; // Add a literal backslash
-									break;
-								case '"':
-									f_CurrentStringLiteral += '"'; // Add a literal double quote
-									break;
-								default:
-									// Handle unknown escape sequences or add a fallback behavior
-									f_CurrentStringLiteral += '\\'; // Re-add the backslash as it was part of the input
-									f_CurrentStringLiteral += f_CurrentChar; // Add the unknown character as is
-									break;
-							}
-						}
-						else
-						{
-							f_CurrentStringLiteral += f_CurrentChar;
-						}
-
-						f_CurrentChar = ShiftForward(fp_SourceCode); //shift to next character
-					}
-
-					// Check if we've ended on the closing quotation mark
-					if (f_CurrentChar == '"')
-					{
-						// Push the final string token without the quotes
-						fp_Tokens.emplace_back(f_CurrentStringLiteral, TokenType::StringLiteral, f_CurrentLineNumber);
-						continue; //move to next iteration, lexer will shift on next iteration, f_CurrentChar is pointing -> ' " ' 
-					}
-					else // Handle error: Unterminated string literal, and exit program execution
-					{
-						logger->LogAndPrint("Unterminated string literal, brother! Error occured at line number: " + to_string(f_CurrentLineNumber), "Lexer", LogManager::LogLevel::Error);
-						fp_SourceCode.clear();
-						return false;
-					}
-				}
-				break;
-				default:
-					logger->LogAndPrint(format("Lexing Error: Unrecognized character found: [{}], found at line number: {}", f_CurrentChar, f_CurrentLineNumber), "Lexer", LogManager::LogLevel::Error);
-					fp_SourceCode.clear(); //dump the source code vector, so that the compiler will stop processing the source code
-					return false;
-				}
-
-			}
-
-			fp_Tokens.emplace_back("", TokenType::ENDF, f_CurrentLineNumber); //label the end of the file i guess for some reason
-
-			return true; //fuck C++
-		}
+		using TokenType = JSONTokenType;
+		using Token = JSONToken;
 
 		//////////////////////////////////////////////
 		// JSON Parsing
@@ -794,7 +501,7 @@ namespace Princess {
 
 			static_assert(is_serializable_struct<T>::value, "FromJSON() can only be used with types that use SERIALIZABLE_FIELDS");
 
-			const vector<string> fieldNames = SplitFieldNames(T::field_names);
+			static const vector<string> fieldNames = SplitFieldNames(T::field_names); //split once per type, not once for every object loaded
 
 			const JSONObject& json = get<JSONObject>(_j.m_Value);
 
@@ -889,6 +596,8 @@ namespace Princess {
 								e.what()));
 							return false;
 						}
+
+						return true;
 					}(), ...
 						);
 				});
@@ -929,19 +638,58 @@ namespace Princess {
 		//////////////////////////////////////////////
 		// Parsing Utilities
 		//////////////////////////////////////////////
+		/*
+		The parser pulls tokens out of the lexer one at a time instead of working through a token vector, every parse function shares one
+		Token that the lexer writes straight into. Nothing but the JSONValue being built outlives the token it came from, so the peak
+		memory of a load is the source plus the DOM.
+		*/
 
-		[[nodiscard]] Token
-			ShiftForward(vector<Token>&fp_TokenVector)
+		[[nodiscard]] bool
+			ShiftForward(JSONLexer& fp_Lexer, Token& fp_CurrentToken) //false on a lexing error, the lexer has already logged it by then
 		{
-			if (fp_TokenVector.empty())
+			return fp_Lexer.Next(fp_CurrentToken);
+		}
+
+		bool
+			ParseNumber(const Token& fp_CurrentToken, JSONValue& fp_Number, Logger* logger) //reads the token's slice of the source in place, no string gets built for it
+		{
+			const char* f_Begin = fp_CurrentToken.m_Value.data();
+			const char* f_End = f_Begin + fp_CurrentToken.m_Value.size();
+
+			from_chars_result f_Result;
+
+			if (fp_CurrentToken.m_Type == TokenType::FloatLiteral)
 			{
-				return Token("EOF", TokenType::ENDF, -1); //return escape char when source code is done being read
+				double f_Float = 0.0;
+				f_Result = from_chars(f_Begin, f_End, f_Float);
+				fp_Number = JSONValue(f_Float);
+			}
+			else if (fp_CurrentToken.m_Value[0] == '-') //XXX: this is used to handle container sizing issues coming from values serialized as a large uint64 vs a regular int64
+			{
+				int64_t f_Signed = 0;
+				f_Result = from_chars(f_Begin, f_End, f_Signed);
+				fp_Number = JSONValue(f_Signed);
+			}
+			else //store any positive number as a uint64 because y not we'll recast it at deserialization
+			{
+				uint64_t f_Unsigned = 0;
+				f_Result = from_chars(f_Begin, f_End, f_Unsigned);
+				fp_Number = JSONValue(f_Unsigned);
 			}
 
-			Token f_FirstElement = fp_TokenVector.front();
-			fp_TokenVector.erase(fp_TokenVector.begin());
+			if (f_Result.ec == errc::result_out_of_range)
+			{
+				logger->LogAndPrint(format("Parsing Error: number '{}' doesn't fit in 64 bits, at line number: {}", fp_CurrentToken.m_Value, fp_CurrentToken.m_SourceCodeLineNumber), "ParseNumber", Logger::LogLevel::Error);
+				return false;
+			}
+
+			if (f_Result.ec != errc() or f_Result.ptr != f_End) //anything the lexer lets through that from_chars() can't read in full, not a range problem
+			{
+				logger->LogAndPrint(format("Parsing Error: invalid number '{}', at line number: {}", fp_CurrentToken.m_Value, fp_CurrentToken.m_SourceCodeLineNumber), "ParseNumber", Logger::LogLevel::Error);
+				return false;
+			}
 
-			return f_FirstElement;
+			return true;
 		}
 
 		//////////////////////////////////////////////
@@ -951,60 +699,69 @@ namespace Princess {
 		bool
 			ParseObject
 			(
-				vector<Token>&fp_Tokens,
+				JSONLexer& fp_Lexer,
+				Token& fp_CurrentToken,
 				JSONObject& fp_JSONObject, //current list containing the entire parsed JSON up to this point
-				LogManager* logger
+				Logger* logger
 			)
 		{
-			string f_CurrentKey;
-
-			Token f_CurrentToken = ShiftForward(fp_Tokens); //shift forwards one and check for a string key, assuming the last token was '{'
+			if (not ShiftForward(fp_Lexer, fp_CurrentToken)) //shift forwards one and check for a string key, assuming the last token was '{'
+			{
+				return false;
+			}
 
-			while (f_CurrentToken.m_Type != TokenType::CloseBracket) //this will break out of the loop if it parses towards ENDF for invalid JSONS in the worst cases
+			while (fp_CurrentToken.m_Type != TokenType::CloseBracket) //this will break out of the loop if it parses towards ENDF for invalid JSONS in the worst cases
 			{
-				if (f_CurrentToken.m_Type != TokenType::StringLiteral)
+				if (fp_CurrentToken.m_Type != TokenType::StringLiteral)
 				{
-					logger->LogAndPrint(format("Parsing Error: found '{}', when string literal was expected as JSON key inside object at line number: {}", f_CurrentToken.m_Value, f_CurrentToken.m_SourceCodeLineNumber), "ParseObject", LogManager::LogLevel::Error);
+					logger->LogAndPrint(format("Parsing Error: found '{}', when string literal was expected as JSON key inside object at line number: {}", fp_CurrentToken.m_Value, fp_CurrentToken.m_SourceCodeLineNumber), "ParseObject", Logger::LogLevel::Error);
 					return false;
 				}
 
-				f_CurrentKey = move(f_CurrentToken.m_Value);
-				f_CurrentToken = ShiftForward(fp_Tokens); //look for ':'
+				string f_CurrentKey = fp_CurrentToken.GetString();
+
+				if (not ShiftForward(fp_Lexer, fp_CurrentToken)) //look for ':'
+				{
+					return false;
+				}
 
-				if (f_CurrentToken.m_Type != TokenType::DoubleDot)
+				if (fp_CurrentToken.m_Type != TokenType::DoubleDot)
 				{
-					logger->LogAndPrint(format("Parsing Error: found '{}', when ':' was expected after JSON key inside object at line number: {}", f_CurrentToken.m_Value, f_CurrentToken.m_SourceCodeLineNumber), "ParseObject", LogManager::LogLevel::Error);
+					logger->LogAndPrint(format("Parsing Error: found '{}', when ':' was expected after JSON key inside object at line number: {}", fp_CurrentToken.m_Value, fp_CurrentToken.m_SourceCodeLineNumber), "ParseObject", Logger::LogLevel::Error);
 					return false;
 				}
 
-				f_CurrentToken = ShiftForward(fp_Tokens); //look for value associated with key
+				if (not ShiftForward(fp_Lexer, fp_CurrentToken)) //look for value associated with key
+				{
+					return false;
+				}
 
-				if (not ParseValue(f_CurrentToken, fp_JSONObject, f_CurrentKey, fp_Tokens, logger))
+				if (not ParseValue(fp_Lexer, fp_CurrentToken, fp_JSONObject, f_CurrentKey, logger))
 				{
-					logger->LogAndPrint(format("Parsing Error: Invalid JSON object: '{}', at line number: {}", f_CurrentToken.m_Value, f_CurrentToken.m_SourceCodeLineNumber), "ParseObject", LogManager::LogLevel::Error);
+					logger->LogAndPrint(format("Parsing Error: Invalid JSON object: '{}', at line number: {}", fp_CurrentToken.m_Value, fp_CurrentToken.m_SourceCodeLineNumber), "ParseObject", Logger::LogLevel::Error);
 					return false;
 				}
 
-				f_CurrentToken = ShiftForward(fp_Tokens); //look for comma or close bracket
+				if (not ShiftForward(fp_Lexer, fp_CurrentToken)) //look for comma or close bracket
+				{
+					return false;
+				}
 
-				if (f_CurrentToken.m_Type == TokenType::CloseBracket)
+				if (fp_CurrentToken.m_Type == TokenType::CloseBracket)
 				{
 					break;
 				}
 
-				if (f_CurrentToken.m_Type != TokenType::Comma)
+				if (fp_CurrentToken.m_Type != TokenType::Comma)
 				{
-					logger->LogAndPrint(format("Parsing Error: found '{}', when ',' was expected after JSON value inside object at line number: {}", f_CurrentToken.m_Value, f_CurrentToken.m_SourceCodeLineNumber), "ParseObject", LogManager::LogLevel::Error);
+					logger->LogAndPrint(format("Parsing Error: found '{}', when ',' was expected after JSON value inside object at line number: {}", fp_CurrentToken.m_Value, fp_CurrentToken.m_SourceCodeLineNumber), "ParseObject", Logger::LogLevel::Error);
 					return false;
 				}
 
-				f_CurrentToken = ShiftForward(fp_Tokens); // consume comma, and look for next key value pair
-			}
-
-			if (f_CurrentToken.m_Type != TokenType::CloseBracket)
-			{
-				logger->LogAndPrint(format("Parsing Error: Unexpected token: [{}], found inside array definition at line number: {}", f_CurrentToken.m_Value, f_CurrentToken.m_SourceCodeLineNumber), "ParseObject", LogManager::LogLevel::Error);
-				return false;
+				if (not ShiftForward(fp_Lexer, fp_CurrentToken)) // consume comma, and look for next key value pair
+				{
+					return false;
+				}
 			}
 
 			return true;
@@ -1013,41 +770,45 @@ namespace Princess {
 		bool
 			ParseArray
 			(
-				vector<Token>&fp_Tokens,
+				JSONLexer& fp_Lexer,
+				Token& fp_CurrentToken,
 				JSONArray& fp_JSONArray, //current list containing the entire parsed JSON up to this point
-				LogManager* logger
+				Logger* logger
 			)
 		{
-			Token f_CurrentToken = ShiftForward(fp_Tokens); //assuming the most recent token was '[' called from ParseJSON
+			if (not ShiftForward(fp_Lexer, fp_CurrentToken)) //assuming the most recent token was '[' called from ParseJSON
+			{
+				return false;
+			}
 
-			while (f_CurrentToken.m_Type != TokenType::CloseSquareBracket) //this will break out of the loop if it parses towards ENDF for invalid JSONS in the worst cases
+			while (fp_CurrentToken.m_Type != TokenType::CloseSquareBracket) //this will break out of the loop if it parses towards ENDF for invalid JSONS in the worst cases
 			{
-				if (not ParseValue(f_CurrentToken, fp_JSONArray, fp_Tokens, logger))
+				if (not ParseValue(fp_Lexer, fp_CurrentToken, fp_JSONArray, logger))
 				{
-					logger->LogAndPrint("Parsing Error: invalid value found while parsing an Array", "ParseArray", LogManager::LogLevel::Error);
+					logger->LogAndPrint("Parsing Error: invalid value found while parsing an Array", "ParseArray", Logger::LogLevel::Error);
 					return false;
 				}
 
-				f_CurrentToken = ShiftForward(fp_Tokens); //shift to find comma
+				if (not ShiftForward(fp_Lexer, fp_CurrentToken)) //shift to find comma
+				{
+					return false;
+				}
 
-				if (f_CurrentToken.m_Type == TokenType::CloseSquareBracket) // check for end of array before we check for comma
+				if (fp_CurrentToken.m_Type == TokenType::CloseSquareBracket) // check for end of array before we check for comma
 				{
 					break;
 				}
 
-				if (f_CurrentToken.m_Type != TokenType::Comma) //throw error if a separating comma is not found between array elements
+				if (fp_CurrentToken.m_Type != TokenType::Comma) //throw error if a separating comma is not found between array elements
 				{
-					logger->LogAndPrint(format("Parsing Error: expected ',' after value inside JSON array but found '{}' instead at line number: {}", f_CurrentToken.m_Value, f_CurrentToken.m_SourceCodeLineNumber), "ParseArray", LogManager::LogLevel::Error);
+					logger->LogAndPrint(format("Parsing Error: expected ',' after value inside JSON array but found '{}' instead at line number: {}", fp_CurrentToken.m_Value, fp_CurrentToken.m_SourceCodeLineNumber), "ParseArray", Logger::LogLevel::Error);
 					return false;
 				}
 
-				f_CurrentToken = ShiftForward(fp_Tokens); //shift past the comma to find the next value
-			}
-
-			if (f_CurrentToken.m_Type != TokenType::CloseSquareBracket)
-			{
-				logger->LogAndPrint(format("Parsing Error: Expected ']' but found '{}' instead, found inside array definition at line number: {}", f_CurrentToken.m_Value, f_CurrentToken.m_SourceCodeLineNumber), "ParseArray", LogManager::LogLevel::Error);
-				return false;
+				if (not ShiftForward(fp_Lexer, fp_CurrentToken)) //shift past the comma to find the next value
+				{
+					return false;
+				}
 			}
 
 			return true;
@@ -1056,30 +817,30 @@ namespace Princess {
 		bool
 			ParseValue //used for parsing values inside an array
 			(
-				Token fp_CurrentToken,
+				JSONLexer& fp_Lexer,
+				Token& fp_CurrentToken,
 				JSONArray& fp_Array,
-				vector<Token>& fp_Tokens,
-				LogManager* logger
+				Logger* logger
 			)
 		{
 			switch (fp_CurrentToken.m_Type)
 			{
 				case TokenType::StringLiteral:
-					fp_Array.emplace_back(fp_CurrentToken.m_Value);
+					fp_Array.emplace_back(fp_CurrentToken.GetString());
 					break;
 				case TokenType::IntLiteral:
-					if (fp_CurrentToken.m_Value[0] == '-') //store any positive number as a uint64 because y not we'll recast it at deserialization
-					{
-						fp_Array.emplace_back(static_cast<int64_t>(stoll(fp_CurrentToken.m_Value))); // signed
-					}
-					else
+				case TokenType::FloatLiteral:
+				{
+					JSONValue f_Number;
+
+					if (not ParseNumber(fp_CurrentToken, f_Number, logger))
 					{
-						fp_Array.emplace_back(static_cast<uint64_t>(stoull(fp_CurrentToken.m_Value))); // unsigned
+						return false;
 					}
-					break;
-				case TokenType::FloatLiteral:
-					fp_Array.emplace_back(stod(fp_CurrentToken.m_Value));
-					break;
+
+					fp_Array.push_back(move(f_Number));
+				}
+				break;
 				case TokenType::BoolLiteral:
 					fp_Array.emplace_back(fp_CurrentToken.m_Value == "true");
 					break;
@@ -1090,19 +851,29 @@ namespace Princess {
 				case TokenType::OpenBracket: //check for nested objects
 				{
 					JSONObject f_TempObject;
-					ParseObject(fp_Tokens, f_TempObject, logger);
-					fp_Array.emplace_back(f_TempObject);
+
+					if (not ParseObject(fp_Lexer, fp_CurrentToken, f_TempObject, logger))
+					{
+						return false;
+					}
+
+					fp_Array.emplace_back(move(f_TempObject)); //moved, a copy here would copy the whole subtree once for every level it's nested in
 				}
 				break;
 				case TokenType::OpenSquareBracket: //check for nested arrays
 				{
 					JSONArray f_TempArray;
-					ParseArray(fp_Tokens, f_TempArray, logger);
-					fp_Array.emplace_back(f_TempArray);
+
+					if (not ParseArray(fp_Lexer, fp_CurrentToken, f_TempArray, logger))
+					{
+						return false;
+					}
+
+					fp_Array.emplace_back(move(f_TempArray));
 				}
 				break;
 				default:
-					logger->LogAndPrint(format("Parsing Error: found '{}' inside array, when integral type was expected at line number: {}", fp_CurrentToken.m_Value, fp_CurrentToken.m_SourceCodeLineNumber), "ParseValue", LogManager::LogLevel::Error);
+					logger->LogAndPrint(format("Parsing Error: found '{}' inside array, when integral type was expected at line number: {}", fp_CurrentToken.m_Value, fp_CurrentToken.m_SourceCodeLineNumber), "ParseValue", Logger::LogLevel::Error);
 					return false;
 			}
 
@@ -1112,54 +883,64 @@ namespace Princess {
 		bool
 			ParseValue //used for parsing values inside a regular JSON object
 			(
-				Token fp_CurrentToken,
+				JSONLexer& fp_Lexer,
+				Token& fp_CurrentToken,
 				JSONObject& fp_JSONObject,
 				string& fp_ValueKey,
-				vector<Token>& fp_Tokens,
-				LogManager* logger
+				Logger* logger
 			)
 		{
 			switch (fp_CurrentToken.m_Type)
 			{
 				case TokenType::StringLiteral:
-					fp_JSONObject.emplace(fp_ValueKey, fp_CurrentToken.m_Value);
+					fp_JSONObject.emplace(move(fp_ValueKey), fp_CurrentToken.GetString());
 					break;
 				case TokenType::IntLiteral:
-					if (fp_CurrentToken.m_Value[0] == '-') //XXX: this is used to handle container sizing issues coming from values serialized as a large uint64 vs a regular int64
-					{
-						fp_JSONObject.emplace(fp_ValueKey, static_cast<int64_t>(stoll(fp_CurrentToken.m_Value))); // signed
-					}
-					else
+				case TokenType::FloatLiteral:
+				{
+					JSONValue f_Number;
+
+					if (not ParseNumber(fp_CurrentToken, f_Number, logger))
 					{
-						fp_JSONObject.emplace(fp_ValueKey, static_cast<uint64_t>(stoull(fp_CurrentToken.m_Value))); // unsigned
+						return false;
 					}
-					break;
-				case TokenType::FloatLiteral:
-					fp_JSONObject.emplace(fp_ValueKey, stod(fp_CurrentToken.m_Value));
-					break;
+
+					fp_JSONObject.emplace(move(fp_ValueKey), move(f_Number));
+				}
+				break;
 				case TokenType::BoolLiteral:
-					fp_JSONObject.emplace(fp_ValueKey, fp_CurrentToken.m_Value == "true");
+					fp_JSONObject.emplace(move(fp_ValueKey), fp_CurrentToken.m_Value == "true");
 					break;
 				case TokenType::NullLiteral:
-					fp_JSONObject.emplace(fp_ValueKey, JSONValue());
+					fp_JSONObject.emplace(move(fp_ValueKey), JSONValue());
 					break;
 
 				case TokenType::OpenBracket:
 				{
 					JSONObject f_TempObject;
-					ParseObject(fp_Tokens, f_TempObject, logger);
-					fp_JSONObject.emplace(fp_ValueKey, f_TempObject);
+
+					if (not ParseObject(fp_Lexer, fp_CurrentToken, f_TempObject, logger))
+					{
+						return false;
+					}
+
+					fp_JSONObject.emplace(move(fp_ValueKey), move(f_TempObject));
 				}
 				break;
 				case TokenType::OpenSquareBracket:
 				{
 					JSONArray f_TempArray;
-					ParseArray(fp_Tokens, f_TempArray, logger);
-					fp_JSONObject.emplace(fp_ValueKey, f_TempArray);
+
+					if (not ParseArray(fp_Lexer, fp_CurrentToken, f_TempArray, logger))
+					{
+						return false;
+					}
+
+					fp_JSONObject.emplace(move(fp_ValueKey), move(f_TempArray));
 				}
 				break;
 				default:
-					logger->LogAndPrint(format("Parsing Error: found '{}' inside object, when integral type was expected at line number: {}", fp_CurrentToken.m_Value, fp_CurrentToken.m_SourceCodeLineNumber), "ParseValue", LogManager::LogLevel::Error);
+					logger->LogAndPrint(format("Parsing Error: found '{}' inside object, when integral type was expected at line number: {}", fp_CurrentToken.m_Value, fp_CurrentToken.m_SourceCodeLineNumber), "ParseValue", Logger::LogLevel::Error);
 					return false;
 			}
 
@@ -1169,39 +950,53 @@ namespace Princess {
 		bool //XXX: this function assumes that the JSON is structured such that it has one top level object denoted by a "{ . . . . }"
 			ParseJSON //function call that kicks off the recursive parse chain
 			(
-				vector<Token>& fp_Tokens,
+				const string_view fp_SourceCode,
 				JSONValue& fp_JSON,
-				LogManager* logger
+				Logger* logger
 			)
 		{
-			Token f_CurrentToken = ShiftForward(fp_Tokens); //get first val
+			JSONLexer f_Lexer(fp_SourceCode, logger);
+			Token f_CurrentToken;
+
+			if (not ShiftForward(f_Lexer, f_CurrentToken)) //get first val
+			{
+				return false;
+			}
 
 			switch (f_CurrentToken.m_Type) //should only need to do this once for a valid JSON
 			{
 				case TokenType::OpenBracket:
 				{
 					JSONObject f_Object;
-					ParseObject(fp_Tokens, f_Object, logger);
-					fp_JSON = move(JSONValue(f_Object));
+
+					if (not ParseObject(f_Lexer, f_CurrentToken, f_Object, logger))
+					{
+						return false;
+					}
+
+					fp_JSON = JSONValue(move(f_Object));
 				}
 				break;
 				case TokenType::OpenSquareBracket:
 				{
 					JSONArray f_Array;
-					ParseArray(fp_Tokens, f_Array, logger);
-					fp_JSON = move(JSONValue(f_Array));
+
+					if (not ParseArray(f_Lexer, f_CurrentToken, f_Array, logger))
+					{
+						return false;
+					}
+
+					fp_JSON = JSONValue(move(f_Array));
 				}
 				break;
 				default:
-					logger->LogAndPrint("Parsing Error: ill-formed JSON found, parsing failed", "ParseJSON", LogManager::LogLevel::Error);
+					logger->LogAndPrint("Parsing Error: ill-formed JSON found, parsing failed", "ParseJSON", Logger::LogLevel::Error);
 					return false;
 			}
 
-			f_CurrentToken = ShiftForward(fp_Tokens); //check for ENDF
-
-			if (f_CurrentToken.m_Type != TokenType::ENDF)
+			if (not ShiftForward(f_Lexer, f_CurrentToken) or f_CurrentToken.m_Type != TokenType::ENDF) //check for ENDF
 			{
-				logger->LogAndPrint("Parsing Error: parser failed to find end of file, something bad happened and I have 0 clue why lmfao. JSONValue isn't properly formed", "ParseJSON", LogManager::LogLevel::Error);
+				logger->LogAndPrint("Parsing Error: parser failed to find end of file, something bad happened and I have 0 clue why lmfao. JSONValue isn't properly formed", "ParseJSON", Logger::LogLevel::Error);
 				fp_JSON = JSONValue();
 				return false;
 			}
@@ -1219,7 +1014,7 @@ namespace Princess {
 				const string& fp_DesiredOutputDirectory,
 				const string& fp_DesiredName,
 				const JSONValue& fp_JSON,
-				LogManager* logger
+				Logger* logger
 			)
 			const
 		{
@@ -1232,7 +1027,7 @@ namespace Princess {
 			// Ensure directory exists
 			if (not filesystem::exists(fp_DesiredOutputDirectory))
 			{
-				logger->LogAndPrint("Serialization Error: Tried to pass invalid write directory to WriteToJSON", "Serializer", LogManager::LogLevel::Error);
+				logger->LogAndPrint("Serialization Error: Tried to pass invalid write directory to WriteToJSON", "Serializer", Logger::LogLevel::Error);
 				return false;
 			}
 
@@ -1242,7 +1037,7 @@ namespace Princess {
 
 			if (not file)
 			{
-				logger->LogAndPrint(format("Serialization Error: Failed to open file: '{}' for writing.", f_FileName), "Serializer", LogManager::LogLevel::Error);
+				logger->LogAndPrint(format("Serialization Error: Failed to open file: '{}' for writing.", f_FileName), "Serializer", Logger::LogLevel::Error);
 				return false;
 			}
 
@@ -1250,7 +1045,7 @@ namespace Princess {
 
 			if (not ToString(&f_JSONString, fp_JSON))
 			{
-				logger->LogAndPrint(format("Serialization Error: Failed to stringify JSON for writing -> file: '{}' for writing.", f_FileName), "Serializer", LogManager::LogLevel::Error);
+				logger->LogAndPrint(format("Serialization Error: Failed to stringify JSON for writing -> file: '{}' for writing.", f_FileName), "Serializer", Logger::LogLevel::Error);
 				file.close(); //close the file since writing failed
 				return false;
 			}
@@ -1264,62 +1059,42 @@ namespace Princess {
 		}
 
 		bool
-			ReadJSONIntoString
+			OpenJSONFile
 			(
-				const string& fp_ScriptFilePath,
-				string* fp_SourceCode,
-				LogManager* logger
+				const string& fp_FilePath, //a path on disk, or one inside a PhysFS mount
+				SourceFile& fp_JsonFile,
+				Logger* logger
 			)
 		{
 			if (not logger)
 			{
-				PrintError("Serialization Error: Tried to pass nullptr reference to logger during ReadJSONIntoString()");
-				return false;
-			}
-
-			//check for nullptr
-			if (not fp_SourceCode)
-			{
-				logger->LogAndPrint("Serialization Error: Nullptr reference passed to ReadJSONIntoString", "Serializer", LogManager::LogLevel::Error);
-				return false;
-			}
-
-			// Ensure directory exists
-			if (not filesystem::exists(fp_ScriptFilePath))
-			{
-				logger->LogAndPrint("Serialization Error: Tried to pass invalid filepath to ReadJSONIntoString", "Serializer", LogManager::LogLevel::Error);
+				PrintError("Serialization Error: Tried to pass nullptr reference to logger during OpenJSONFile()");
 				return false;
 			}
 
 			// Extract file extension assuming format "filename.ext"
-			size_t lastDotIndex = fp_ScriptFilePath.rfind('.');
+			size_t lastDotIndex = fp_FilePath.rfind('.');
 
 			if (lastDotIndex == string::npos)
 			{
-				logger->LogAndPrint("Serialization Error: No file extension found", "Serializer", LogManager::LogLevel::Error);
+				logger->LogAndPrint("Serialization Error: No file extension found", "Serializer", Logger::LogLevel::Error);
 				return false;
 			}
 
-			string f_FileExtension = fp_ScriptFilePath.substr(lastDotIndex);
+			string f_FileExtension = fp_FilePath.substr(lastDotIndex);
 
 			if (f_FileExtension != ".json")
 			{
-				logger->LogAndPrint("Serialization Error: Attempted to read from a file that isn't a JSON", "Serializer", LogManager::LogLevel::Error);
+				logger->LogAndPrint("Serialization Error: Attempted to read from a file that isn't a JSON", "Serializer", Logger::LogLevel::Error);
 				return false;
 			}
 
-			ifstream f_FileStream(fp_ScriptFilePath, ios::in);
-
-			if (not f_FileStream)
+			if (not fp_JsonFile.Open(fp_FilePath, logger))
 			{
-				logger->LogAndPrint("Serialization Error: Failed to open JSON for reading.", "Serializer", LogManager::LogLevel::Error);
+				logger->LogAndPrint("Serialization Error: Failed to open JSON for reading.", "Serializer", Logger::LogLevel::Error);
 				return false;
 			}
 
-			stringstream f_StringBuffer;
-			f_StringBuffer << f_FileStream.rdbuf();
-			*fp_SourceCode = f_StringBuffer.str();
-
 			return true;
 		}
 	};
@@ -0,0 +1,259 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Princess {
+
+    //////////////////////////////////////////////
+    // Generational Handle
+    //////////////////////////////////////////////
+
+    struct SlotHandle
+    {
+        uint32_t m_Index = 0; //slot 0 is never handed out, so a default constructed handle is the null handle
+        uint32_t m_Generation = 0;
+
+        [[nodiscard]] constexpr bool
+            IsNull()
+            const
+        {
+            return m_Index == 0;
+        }
+
+        friend constexpr bool operator==(const SlotHandle&, const SlotHandle&) = default;
+    };
+
+    //////////////////////////////////////////////
+    // Slot Map
+    //////////////////////////////////////////////
+    /*
+    Values live packed inside a dense array so iterating everything stays a linear scan, and erasing swaps the last value into the hole.
+    Handles point at a slot instead, the slot knows where its value currently sits in the dense array and carries a generation that gets
+    bumped every time the slot is freed. A handle whose generation doesn't match anymore is stale and Get() returns nullptr for it, so
+    recycled slots can never be confused with the value that used to live there.
+    Retire() takes a value out without freeing its slot, so an undone removal can Revive() it under the handle everybody already holds.
+    */
+
+    template<typename T>
+    class SlotMap
+    {
+    public:
+        SlotMap()
+        {
+            Clear();
+        }
+
+    public:
+        [[nodiscard]] SlotHandle
+            Insert(T fp_Value)
+        {
+            uint32_t f_SlotIndex;
+
+            if (pm_FreeListHead != 0)
+            {
+                f_SlotIndex = pm_FreeListHead;
+                pm_FreeListHead = pm_Slots[f_SlotIndex].m_DenseIndexOrNextFree;
+            }
+            else
+            {
+                f_SlotIndex = static_cast<uint32_t>(pm_Slots.size());
+                pm_Slots.push_back({});
+            }
+
+            Slot& f_Slot = pm_Slots[f_SlotIndex];
+            f_Slot.m_DenseIndexOrNextFree = static_cast<uint32_t>(pm_Values.size());
+
+            pm_Values.push_back(std::move(fp_Value));
+            pm_DenseToSlot.push_back(f_SlotIndex);
+
+            return { f_SlotIndex, f_Slot.m_Generation };
+        }
+
+        bool
+            Erase(const SlotHandle fp_Handle)
+        {
+            if (not Contains(fp_Handle))
+            {
+                return false;
+            }
+
+            RemoveFromDense(pm_Slots[fp_Handle.m_Index].m_DenseIndexOrNextFree);
+            FreeSlot(fp_Handle.m_Index);
+
+            return true;
+        }
+
+        bool
+            Retire(const SlotHandle fp_Handle) //like Erase() but the slot stays reserved with its generation untouched, so Revive() can hand the same handle back later
+        {
+            if (not Contains(fp_Handle))
+            {
+                return false;
+            }
+
+            RemoveFromDense(pm_Slots[fp_Handle.m_Index].m_DenseIndexOrNextFree);
+            pm_Slots[fp_Handle.m_Index].m_DenseIndexOrNextFree = RETIRED_SLOT;
+
+            return true;
+        }
+
+        bool
+            Revive(const SlotHandle fp_Handle, T fp_Value)
+        {
+            if (not IsRetired(fp_Handle))
+            {
+                return false;
+            }
+
+            pm_Slots[fp_Handle.m_Index].m_DenseIndexOrNextFree = static_cast<uint32_t>(pm_Values.size());
+
+            pm_Values.push_back(std::move(fp_Value));
+            pm_DenseToSlot.push_back(fp_Handle.m_Index);
+
+            return true;
+        }
+
+        bool
+            ReleaseRetired(const SlotHandle fp_Handle) //gives a retired slot back to the free list, its handle goes stale for good
+        {
+            if (not IsRetired(fp_Handle))
+            {
+                return false;
+            }
+
+            FreeSlot(fp_Handle.m_Index);
+            return true;
+        }
+
+        [[nodiscard]] bool
+            IsRetired(const SlotHandle fp_Handle)
+            const
+        {
+            return fp_Handle.m_Index != 0
+                and fp_Handle.m_Index < pm_Slots.size()
+                and pm_Slots[fp_Handle.m_Index].m_Generation == fp_Handle.m_Generation
+                and pm_Slots[fp_Handle.m_Index].m_DenseIndexOrNextFree == RETIRED_SLOT;
+        }
+
+        [[nodiscard]] bool
+            Contains(const SlotHandle fp_Handle)
+            const
+        {
+            return fp_Handle.m_Index != 0
+                and fp_Handle.m_Index < pm_Slots.size()
+                and pm_Slots[fp_Handle.m_Index].m_Generation == fp_Handle.m_Generation
+                and pm_Slots[fp_Handle.m_Index].m_DenseIndexOrNextFree < pm_Values.size()
+                and pm_DenseToSlot[pm_Slots[fp_Handle.m_Index].m_DenseIndexOrNextFree] == fp_Handle.m_Index;
+        }
+
+        [[nodiscard]] T*
+            Get(const SlotHandle fp_Handle)
+        {
+            return Contains(fp_Handle) ? &pm_Values[pm_Slots[fp_Handle.m_Index].m_DenseIndexOrNextFree] : nullptr;
+        }
+
+        [[nodiscard]] const T*
+            Get(const SlotHandle fp_Handle)
+            const
+        {
+            return Contains(fp_Handle) ? &pm_Values[pm_Slots[fp_Handle.m_Index].m_DenseIndexOrNextFree] : nullptr;
+        }
+
+        void
+            Clear() //generations are kept on purpose, handles from before the clear must stay stale
+        {
+            pm_Values.clear();
+            pm_DenseToSlot.clear();
+
+            if (pm_Slots.empty())
+            {
+                pm_Slots.push_back({}); //reserve slot 0 for the null handle
+            }
+
+            pm_FreeListHead = 0;
+
+            for (uint32_t l_Index = static_cast<uint32_t>(pm_Slots.size() - 1); l_Index > 0; l_Index--)
+            {
+                pm_Slots[l_Index].m_Generation++;
+                pm_Slots[l_Index].m_DenseIndexOrNextFree = pm_FreeListHead;
+                pm_FreeListHead = l_Index;
+            }
+        }
+
+        [[nodiscard]] size_t
+            Size()
+            const
+        {
+            return pm_Values.size();
+        }
+
+        [[nodiscard]] size_t
+            SlotCount() //upper bound for handle indices, handy for sizing per-slot side tables like visited bitsets
+            const
+        {
+            return pm_Slots.size();
+        }
+
+        //////////////////// Dense Iteration ////////////////////
+
+        auto begin() { return pm_Values.begin(); }
+        auto end() { return pm_Values.end(); }
+
+        auto begin() const { return pm_Values.begin(); }
+        auto end() const { return pm_Values.end(); }
+
+    private:
+        void
+            RemoveFromDense(const uint32_t fp_DenseIndex)
+        {
+            const uint32_t f_LastDenseIndex = static_cast<uint32_t>(pm_Values.size() - 1);
+
+            if (fp_DenseIndex != f_LastDenseIndex) //swap the last value into the hole so the dense array stays packed
+            {
+                pm_Values[fp_DenseIndex] = std::move(pm_Values[f_LastDenseIndex]);
+                pm_DenseToSlot[fp_DenseIndex] = pm_DenseToSlot[f_LastDenseIndex];
+                pm_Slots[pm_DenseToSlot[fp_DenseIndex]].m_DenseIndexOrNextFree = fp_DenseIndex;
+            }
+
+            pm_Values.pop_back();
+            pm_DenseToSlot.pop_back();
+        }
+
+        void
+            FreeSlot(const uint32_t fp_SlotIndex)
+        {
+            Slot& f_Slot = pm_Slots[fp_SlotIndex];
+
+            f_Slot.m_Generation++; //invalidates every handle still pointing at this slot
+            f_Slot.m_DenseIndexOrNextFree = pm_FreeListHead;
+            pm_FreeListHead = fp_SlotIndex;
+        }
+
+    private:
+        static constexpr uint32_t RETIRED_SLOT = UINT32_MAX; //m_DenseIndexOrNextFree of a retired slot, never a valid dense index or free list link
+
+        struct Slot
+        {
+            uint32_t m_DenseIndexOrNextFree = 0; //index into pm_Values while alive, next free slot while on the free list
+            uint32_t m_Generation = 0;
+        };
+
+        std::vector<Slot> pm_Slots = {};
+        std::vector<T> pm_Values = {};
+        std::vector<uint32_t> pm_DenseToSlot = {};
+
+        uint32_t pm_FreeListHead = 0;
+    };
+}
@@ -0,0 +1,212 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define PRINCESS_SOURCE_FILE_MMAP
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <physfs.h>
+
+#include "Logger.h"
+
+namespace Princess {
+
+    //////////////////////////////////////////////
+    // Source File
+    //////////////////////////////////////////////
+    /*
+    Read only view over the whole contents of a file, for parsers that want to run straight over the bytes. Files on disk get mapped on
+    unix so nothing is copied at all, and read with one call into a buffer sized from the file length everywhere else. Paths that aren't
+    on disk are looked up in whatever PhysFS has mounted (project archives and the like) and read the same way as on windows.
+    GetContents() stays valid until the next Open(), Close() or until the SourceFile is destroyed. A mapped file that gets truncated
+    while it's open faults the next read of the missing pages, so don't keep one open across a write to the same path.
+    */
+
+    class SourceFile
+    {
+    public:
+        SourceFile() = default;
+        ~SourceFile() { Close(); }
+
+        SourceFile(const SourceFile&) = delete;
+        SourceFile& operator=(const SourceFile&) = delete;
+
+    public:
+        bool
+            Open(const string& fp_FilePath, Logger* logger)
+        {
+            Close();
+
+            error_code f_Error;
+
+            if (filesystem::is_regular_file(fp_FilePath, f_Error)) //disk first, PhysFS only gets asked about paths that aren't there
+            {
+                return OpenNative(fp_FilePath, logger);
+            }
+
+            if (PHYSFS_isInit() and PHYSFS_exists(fp_FilePath.c_str()))
+            {
+                return ReadPhysFS(fp_FilePath, logger);
+            }
+
+            logger->LogAndPrint(format("File Error: '{}' is neither a file on disk nor in any PhysFS mount", fp_FilePath), "SourceFile", Logger::LogLevel::Error);
+            return false;
+        }
+
+        void
+            Close()
+        {
+#ifdef PRINCESS_SOURCE_FILE_MMAP
+            if (pm_MappedBytes)
+            {
+                munmap(pm_MappedBytes, pm_Contents.size());
+                pm_MappedBytes = nullptr;
+            }
+#endif
+            pm_Buffer = string(); //gives the memory back, clear() would hold on to the largest file ever opened
+            pm_Contents = {};
+        }
+
+        string_view
+            GetContents()
+            const
+        {
+            return pm_Contents;
+        }
+
+        bool
+            IsMapped() //false if the contents were read into a buffer instead
+            const
+        {
+            return pm_MappedBytes != nullptr;
+        }
+
+    private:
+#ifdef PRINCESS_SOURCE_FILE_MMAP
+        bool
+            OpenNative(const string& fp_FilePath, Logger* logger)
+        {
+            const int f_Descriptor = open(fp_FilePath.c_str(), O_RDONLY | O_CLOEXEC);
+
+            if (f_Descriptor < 0)
+            {
+                logger->LogAndPrint(format("File Error: failed to open '{}' for reading: {}", fp_FilePath, strerror(errno)), "SourceFile", Logger::LogLevel::Error);
+                return false;
+            }
+
+            struct stat f_Stat;
+            void* f_MappedBytes = nullptr;
+            bool f_Success = fstat(f_Descriptor, &f_Stat) == 0;
+
+            if (f_Success and f_Stat.st_size > 0) //empty files can't be mapped, they just stay an empty view
+            {
+                f_MappedBytes = mmap(nullptr, static_cast<size_t>(f_Stat.st_size), PROT_READ, MAP_PRIVATE, f_Descriptor, 0);
+                f_Success = f_MappedBytes != MAP_FAILED;
+            }
+
+            if (not f_Success)
+            {
+                logger->LogAndPrint(format("File Error: failed to map '{}': {}", fp_FilePath, strerror(errno)), "SourceFile", Logger::LogLevel::Error);
+            }
+
+            close(f_Descriptor); //the mapping holds its own reference to the file
+
+            if (not f_Success or not f_MappedBytes)
+            {
+                return f_Success;
+            }
+
+            madvise(f_MappedBytes, static_cast<size_t>(f_Stat.st_size), MADV_SEQUENTIAL); //parsers read front to back, so the kernel can read ahead aggressively
+
+            pm_MappedBytes = f_MappedBytes;
+            pm_Contents = string_view(static_cast<const char*>(f_MappedBytes), static_cast<size_t>(f_Stat.st_size));
+            return true;
+        }
+#else
+        bool
+            OpenNative(const string& fp_FilePath, Logger* logger)
+        {
+            error_code f_Error;
+            const uintmax_t f_FileSize = filesystem::file_size(fp_FilePath, f_Error);
+            ifstream f_FileStream(fp_FilePath, ios::in | ios::binary);
+
+            if (f_Error or not f_FileStream)
+            {
+                logger->LogAndPrint(format("File Error: failed to open '{}' for reading", fp_FilePath), "SourceFile", Logger::LogLevel::Error);
+                return false;
+            }
+
+            pm_Buffer.resize(static_cast<size_t>(f_FileSize));
+
+            if (not f_FileStream.read(pm_Buffer.data(), static_cast<streamsize>(pm_Buffer.size())))
+            {
+                logger->LogAndPrint(format("File Error: failed to read all {} bytes of '{}'", f_FileSize, fp_FilePath), "SourceFile", Logger::LogLevel::Error);
+                pm_Buffer = string();
+                return false;
+            }
+
+            pm_Contents = pm_Buffer;
+            return true;
+        }
+#endif
+
+        bool
+            ReadPhysFS(const string& fp_FilePath, Logger* logger)
+        {
+            PHYSFS_File* f_File = PHYSFS_openRead(fp_FilePath.c_str());
+
+            if (not f_File)
+            {
+                logger->LogAndPrint(format("File Error: PhysFS failed to open '{}': {}", fp_FilePath, PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode())), "SourceFile", Logger::LogLevel::Error);
+                return false;
+            }
+
+            const PHYSFS_sint64 f_Length = PHYSFS_fileLength(f_File); //-1 when the archive can't tell, nothing here streams so that's a failure
+            bool f_Success = f_Length >= 0;
+
+            if (f_Success)
+            {
+                pm_Buffer.resize(static_cast<size_t>(f_Length));
+                f_Success = PHYSFS_readBytes(f_File, pm_Buffer.data(), pm_Buffer.size()) == f_Length;
+            }
+
+            PHYSFS_close(f_File);
+
+            if (not f_Success)
+            {
+                logger->LogAndPrint(format("File Error: PhysFS failed to read all of '{}'", fp_FilePath), "SourceFile", Logger::LogLevel::Error);
+                pm_Buffer = string();
+                return false;
+            }
+
+            pm_Contents = pm_Buffer;
+            return true;
+        }
+
+    private:
+        string_view pm_Contents = {};
+        string pm_Buffer = {}; //only used when the file couldn't be mapped
+        void* pm_MappedBytes = nullptr;
+    };
+}
@@ -0,0 +1,195 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Princess {
+
+    //////////////////////////////////////////////
+    // Worker Pool
+    //////////////////////////////////////////////
+    /*
+    Persistent threads for data parallel jobs (codegen per root, validation per root, etc). Threads are spun up once and park on a condition
+    variable between jobs so we don't pay thread creation every time the user hits run. The calling thread always joins in on the work,
+    ParallelFor() returns once every index has been processed.
+    */
+
+    class WorkerPool
+    {
+    //////////////////////////////////////////////
+    // Singleton Instance
+    //////////////////////////////////////////////
+    public:
+        static WorkerPool& Pool()
+        {
+            static WorkerPool worker_pool;
+            return worker_pool;
+        }
+
+    //////////////////////////////////////////////
+    // Private Constructor/Destructor
+    //////////////////////////////////////////////
+    private:
+        WorkerPool()
+        {
+            const unsigned int f_HardwareThreads = std::thread::hardware_concurrency();
+            const size_t f_WorkerCount = f_HardwareThreads > 1 ? f_HardwareThreads - 1 : 0; //the caller is a worker too
+
+            for (size_t l_Worker = 0; l_Worker < f_WorkerCount; l_Worker++)
+            {
+                pm_Workers.emplace_back([this, l_Worker] { WorkerLoop(l_Worker + 1); });
+            }
+        }
+
+        ~WorkerPool()
+        {
+            {
+                std::lock_guard<std::mutex> f_Lock(pm_Mutex);
+                pm_IsShuttingDown = true;
+            }
+
+            pm_WakeWorkers.notify_all();
+
+            for (auto& l_Worker : pm_Workers)
+            {
+                l_Worker.join();
+            }
+        }
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+    //////////////////////////////////////////////
+    // Public Methods
+    //////////////////////////////////////////////
+    public:
+        [[nodiscard]] size_t
+            GetThreadCount() //workers + the calling thread, use this to size per-thread scratch buffers
+            const
+        {
+            return pm_Workers.size() + 1;
+        }
+
+        void //fp_Job(index, thread_index), thread_index is 0 for the calling thread and always < GetThreadCount()
+            ParallelFor(const size_t fp_Count, const std::function<void(size_t, size_t)>& fp_Job)
+        {
+            if (fp_Count == 0)
+            {
+                return;
+            }
+
+            if (fp_Count == 1 or pm_Workers.empty())
+            {
+                for (size_t l_Index = 0; l_Index < fp_Count; l_Index++)
+                {
+                    fp_Job(l_Index, 0);
+                }
+
+                return;
+            }
+
+            std::lock_guard<std::mutex> f_JobLock(pm_JobMutex); //one job at a time, nested ParallelFor() calls from inside a job aren't supported
+
+            {
+                std::lock_guard<std::mutex> f_Lock(pm_Mutex);
+                pm_CurrentJob = &fp_Job;
+                pm_JobCount = fp_Count;
+                pm_NextIndex = 0;
+                pm_ActiveWorkers = pm_Workers.size();
+                pm_JobGeneration++;
+            }
+
+            pm_WakeWorkers.notify_all();
+
+            RunJob(fp_Job, fp_Count, 0);
+
+            std::unique_lock<std::mutex> f_Lock(pm_Mutex);
+            pm_JobFinished.wait(f_Lock, [this] { return pm_ActiveWorkers == 0; });
+            pm_CurrentJob = nullptr;
+        }
+
+    //////////////////////////////////////////////
+    // Private Methods
+    //////////////////////////////////////////////
+    private:
+        void
+            RunJob(const std::function<void(size_t, size_t)>& fp_Job, const size_t fp_Count, const size_t fp_ThreadIndex)
+        {
+            for (size_t l_Index = pm_NextIndex.fetch_add(1, std::memory_order_relaxed); l_Index < fp_Count; l_Index = pm_NextIndex.fetch_add(1, std::memory_order_relaxed))
+            {
+                fp_Job(l_Index, fp_ThreadIndex);
+            }
+        }
+
+        void
+            WorkerLoop(const size_t fp_ThreadIndex)
+        {
+            uint64_t f_SeenGeneration = 0;
+
+            while (true)
+            {
+                const std::function<void(size_t, size_t)>* f_Job = nullptr;
+                size_t f_Count = 0;
+
+                {
+                    std::unique_lock<std::mutex> f_Lock(pm_Mutex);
+                    pm_WakeWorkers.wait(f_Lock, [this, f_SeenGeneration] { return pm_IsShuttingDown or pm_JobGeneration != f_SeenGeneration; });
+
+                    if (pm_IsShuttingDown)
+                    {
+                        return;
+                    }
+
+                    f_SeenGeneration = pm_JobGeneration;
+                    f_Job = pm_CurrentJob;
+                    f_Count = pm_JobCount;
+                }
+
+                RunJob(*f_Job, f_Count, fp_ThreadIndex);
+
+                {
+                    std::lock_guard<std::mutex> f_Lock(pm_Mutex);
+
+                    if (--pm_ActiveWorkers == 0)
+                    {
+                        pm_JobFinished.notify_one();
+                    }
+                }
+            }
+        }
+
+    //////////////////////////////////////////////
+    // Private Members
+    //////////////////////////////////////////////
+    private:
+        std::vector<std::thread> pm_Workers = {};
+
+        std::mutex pm_JobMutex;
+        std::mutex pm_Mutex;
+        std::condition_variable pm_WakeWorkers;
+        std::condition_variable pm_JobFinished;
+
+        const std::function<void(size_t, size_t)>* pm_CurrentJob = nullptr;
+        size_t pm_JobCount = 0;
+        std::atomic<size_t> pm_NextIndex = 0;
+        size_t pm_ActiveWorkers = 0;
+        uint64_t pm_JobGeneration = 0;
+
+        bool pm_IsShuttingDown = false;
+    };
+}
@@ -9,163 +9,1737 @@
 /*** GitHub: https://github.com/iLoveJohnFish/Peach-E ***/
 /////////////////////////////////////////////////////////
 #include "../../include/Parsers/ExecutionParser.h"
+#include "../../include/Parsers/PythonScriptParser.h"
+
+#include <algorithm>
 
 namespace Princess {
 
-    string 
-        ExecutionParser::GenerateScript(const BlockNode* fp_StartingBlockNode) 
-        const
+    //Bulk frees the whole graph, used when a project gets closed
+    void 
+        ExecutionParser::ClearAllBlockNodes()
+    {
+        pm_EditHistory.clear(); //no DropEditCommand(), retired nodes go down with the arena and their slots with the slot map
+        pm_EditHistoryFront = 0;
+        pm_EditHistoryCursor = 0;
+        pm_EditHistoryStepCount = 0;
+
+        pm_RootLevelBlockNodeExecutionOrder.clear();
+        pm_AllCurrentlyPlacedBlockNodes.clear();
+        pm_AllCurrentlyPlacedBlockNodeIDs.clear();
+        pm_CurrentScript.Clear();
+        pm_CurrentSourceMap.Clear();
+        pm_CurrentScriptRevision = 0;
+        pm_CurrentScriptHash = SCRIPT_HASH_SEED;
+
+        pm_BlockNodeSlotMap.Clear(); //generations survive the clear, so handles into the closed graph stay stale
+        pm_FlattenedBlockNodeTrees.clear();
+        pm_TopLevelSourceMaps.clear();
+        MarkGraphDirty();
+
+        pm_BlockNodeArena.Clear();
+    }
+
+
+    //O(1) lookup through the slot map, returns nullptr for null, removed or recycled handles
+    BlockNode* 
+        ExecutionParser::FindBlockNode(const BlockNodeHandle fp_BlockNodeID) 
+        const
+    {
+        BlockNode* const* f_BlockNode = pm_BlockNodeSlotMap.Get(fp_BlockNodeID);
+        return f_BlockNode ? *f_BlockNode : nullptr;
+    }
+
+
+    bool 
+        ExecutionParser::IsBlockNodeHandleValid(const BlockNodeHandle fp_BlockNodeID) 
+        const
+    {
+        return pm_BlockNodeSlotMap.Contains(fp_BlockNodeID);
+    }
+
+
+    const vector<BlockNode*>& 
+        ExecutionParser::GetRootLevelBlockNodeExecutionOrder()
+        const
+    {
+        return pm_RootLevelBlockNodeExecutionOrder;
+    }
+
+
+    bool 
+        ExecutionParser::FlagBlockNodeForRootLevelExecution(const BlockNodeHandle fp_BlockNodeID)
+    {
+        BlockNode* f_BlockNode = FindBlockNode(fp_BlockNodeID);
+
+        if (!f_BlockNode or not f_BlockNode->m_ParentID.IsNull()) //nested blocks run as part of their parent, they can't be entry points themselves
+        {
+            return false;
+        }
+
+        if (not f_BlockNode->m_IsRootExecutable)
+        {
+            const BlockNodePlacement f_PreviousPlacement = IsRecordingEdits() ? CaptureBlockNodePlacement(f_BlockNode) : BlockNodePlacement{};
+
+            f_BlockNode->m_IsRootExecutable = true;
+            InsertIntoRootLevelBlockNodeExecutionOrder(f_BlockNode);
+            MarkGraphDirty();
+            RecordPlacementEdit(f_BlockNode, f_PreviousPlacement);
+        }
+
+        return true;
+    }
+
+
+    bool 
+        ExecutionParser::RemoveFlagFromBlockNodeForRootLevelExecution(const BlockNodeHandle fp_BlockNodeID)
+    {
+        BlockNode* f_BlockNode = FindBlockNode(fp_BlockNodeID);
+
+        if (!f_BlockNode) { return false; }
+
+        if (f_BlockNode->m_IsRootExecutable)
+        {
+            const BlockNodePlacement f_PreviousPlacement = IsRecordingEdits() ? CaptureBlockNodePlacement(f_BlockNode) : BlockNodePlacement{};
+
+            EraseFromRootLevelBlockNodeExecutionOrder(f_BlockNode);
+            f_BlockNode->m_IsRootExecutable = false;
+            MarkGraphDirty();
+            RecordPlacementEdit(f_BlockNode, f_PreviousPlacement);
+        }
+
+        return true;
+    }
+
+
+    bool 
+        ExecutionParser::SetBlockNodeInputLineNumber(const BlockNodeHandle fp_BlockNodeID, const unsigned int fp_InputLineNumber)
+    {
+        BlockNode* f_BlockNode = FindBlockNode(fp_BlockNodeID);
+
+        if (!f_BlockNode) { return false; }
+
+        const BlockNodePlacement f_PreviousPlacement = IsRecordingEdits() ? CaptureBlockNodePlacement(f_BlockNode) : BlockNodePlacement{};
+
+        if (f_BlockNode->m_IsRootExecutable) //the index is keyed on the line number, so take it out before the key changes
+        {
+            EraseFromRootLevelBlockNodeExecutionOrder(f_BlockNode);
+            f_BlockNode->m_InputLineNumber = fp_InputLineNumber;
+            InsertIntoRootLevelBlockNodeExecutionOrder(f_BlockNode);
+            MarkGraphDirty();
+        }
+        else
+        {
+            f_BlockNode->m_InputLineNumber = fp_InputLineNumber;
+        }
+
+        RecordPlacementEdit(f_BlockNode, f_PreviousPlacement);
+
+        return true;
+    }
+
+
+    //Binary search for the spot, blocks sharing a line number run in the order they were flagged
+    void 
+        ExecutionParser::InsertIntoRootLevelBlockNodeExecutionOrder(BlockNode* fp_BlockNode)
+    {
+        const auto f_Position = upper_bound
+        (
+            pm_RootLevelBlockNodeExecutionOrder.begin(), pm_RootLevelBlockNodeExecutionOrder.end(), fp_BlockNode->m_InputLineNumber,
+            [](const unsigned int fp_InputLineNumber, const BlockNode* fp_Other)
+            {
+                return fp_InputLineNumber < fp_Other->m_InputLineNumber;
+            }
+        );
+
+        pm_RootLevelBlockNodeExecutionOrder.insert(f_Position, fp_BlockNode);
+    }
+
+
+    void 
+        ExecutionParser::EraseFromRootLevelBlockNodeExecutionOrder(BlockNode* fp_BlockNode)
+    {
+        const auto f_Entry = FindInRootLevelBlockNodeExecutionOrder(fp_BlockNode);
+
+        if (f_Entry != pm_RootLevelBlockNodeExecutionOrder.end())
+        {
+            pm_RootLevelBlockNodeExecutionOrder.erase(f_Entry);
+        }
+    }
+
+
+    vector<BlockNode*>::iterator 
+        ExecutionParser::FindInRootLevelBlockNodeExecutionOrder(const BlockNode* fp_BlockNode)
+    {
+        auto f_Entry = lower_bound
+        (
+            pm_RootLevelBlockNodeExecutionOrder.begin(), pm_RootLevelBlockNodeExecutionOrder.end(), fp_BlockNode->m_InputLineNumber,
+            [](const BlockNode* fp_Other, const unsigned int fp_InputLineNumber)
+            {
+                return fp_Other->m_InputLineNumber < fp_InputLineNumber;
+            }
+        );
+
+        while (f_Entry != pm_RootLevelBlockNodeExecutionOrder.end() and (*f_Entry)->m_InputLineNumber == fp_BlockNode->m_InputLineNumber and *f_Entry != fp_BlockNode) //only scans blocks sharing our line number
+        {
+            ++f_Entry;
+        }
+
+        return f_Entry != pm_RootLevelBlockNodeExecutionOrder.end() and *f_Entry == fp_BlockNode ? f_Entry : pm_RootLevelBlockNodeExecutionOrder.end();
+    }
+
+
+    void 
+        ExecutionParser::GenerateScript(BlockNode* fp_StartingBlockNode, ScriptSink& fp_Sink) 
+    {
+        if (!fp_StartingBlockNode) { return; }
+
+        if (not fp_StartingBlockNode->m_ParentID.IsNull()) //subtree caches are anchored on top level nodes, anything else just gets emitted straight from the snapshot
+        {
+            const FlattenedBlockNodeTree* f_FlattenedTree = CompileBlockNodeTree(fp_StartingBlockNode->m_ID);
+
+            if (f_FlattenedTree and pm_ScriptOptimizationPasses != ScriptOptimizationPasses::None)
+            {
+                pm_IncrementalScratch.m_Optimizer.Optimize(*f_FlattenedTree, pm_ScriptOptimizationPasses).EmitScript(fp_Sink);
+            }
+            else if (f_FlattenedTree)
+            {
+                f_FlattenedTree->EmitScript(fp_Sink); //linear scan over the snapshot, no recursion or pointer chasing
+            }
+            else
+            {
+                DFS(fp_StartingBlockNode, 0, fp_Sink);
+            }
+
+            return;
+        }
+
+        RefreshTopLevelScriptCache(fp_StartingBlockNode, pm_TopLevelSourceMaps[fp_StartingBlockNode->m_ID.m_Index], pm_IncrementalScratch);
+        fp_Sink.Append(fp_StartingBlockNode->m_CachedScript);
+
+        //PeachCore::LogManager::Logger().Debug(" ", "ExecutionParser");
+    }
+
+
+    //Only touches fp_TopLevelBlockNode's own subtree, so different top level nodes can be refreshed from different threads at the same time
+    void 
+        ExecutionParser::RefreshTopLevelScriptCache(BlockNode* fp_TopLevelBlockNode, ScriptSourceMap& fp_SourceMap, CodegenScratch& fp_Scratch)
+    {
+        if (not fp_TopLevelBlockNode->m_IsScriptDirty)
+        {
+            return;
+        }
+
+        fp_Scratch.m_Sink.Clear();
+        fp_Scratch.m_SourceMap.Clear();
+
+        uint32_t f_LineCount = 0;
+
+        if (pm_ScriptOptimizationPasses != ScriptOptimizationPasses::None) //passes can move and drop whole subtrees, so there's nothing to splice from and the root gets regenerated as a whole
+        {
+            fp_Scratch.m_Snapshot.Build(fp_TopLevelBlockNode, fp_TopLevelBlockNode->m_SnapshotRevision); //private snapshot, pm_FlattenedBlockNodeTrees can't be written from the workers
+            f_LineCount = fp_Scratch.m_Optimizer.Optimize(fp_Scratch.m_Snapshot, pm_ScriptOptimizationPasses).EmitScript(fp_Scratch.m_Sink, fp_Scratch.m_SourceMap);
+
+            fp_TopLevelBlockNode->m_CachedLineCount = f_LineCount;
+            MarkBlockNodeSubtreeClean(fp_TopLevelBlockNode, fp_Scratch.m_Traversal);
+        }
+        else
+        {
+            IncrementalEmission f_Emission = { fp_TopLevelBlockNode->m_CachedScript, fp_SourceMap, fp_Scratch.m_Sink, fp_Scratch.m_SourceMap, fp_Scratch.m_EmissionFrames };
+            EmitIncrementally(fp_TopLevelBlockNode, f_Emission, fp_Scratch.m_Traversal);
+            f_LineCount = f_Emission.m_Line;
+        }
+
+        const string_view f_Script = fp_Scratch.m_Sink.View();
+        fp_Scratch.m_SourceMap.SetLineCount(f_LineCount + (not f_Script.empty() and f_Script.back() != '\n' ? 1 : 0));
+
+        fp_TopLevelBlockNode->m_CachedScript.assign(f_Script);
+        fp_SourceMap.Swap(fp_Scratch.m_SourceMap); //the old map becomes the next run's scratch, so neither side reallocates
+    }
+
+
+    //Optimized codegen never reads the per node caches, but MarkBlockNodeDirty() stops at the first dirty ancestor, so the flags still have to be cleared for edits to reach the top level node
+    void 
+        ExecutionParser::MarkBlockNodeSubtreeClean(BlockNode* fp_BlockNode, BlockNodeTraversal& fp_Traversal)
+    {
+        fp_Traversal.Walk
+        (
+            fp_BlockNode,
+            [](BlockNode* fp_Node, const unsigned int fp_Depth)
+            {
+                if (fp_Depth > 0 and not fp_Node->m_IsScriptDirty) //clean nodes only have clean descendants
+                {
+                    return BlockNodeVisit::SkipChildren;
+                }
+
+                fp_Node->m_IsScriptDirty = false;
+                return BlockNodeVisit::Continue;
+            }
+        );
+    }
+
+
+    //Each root is an independent subtree, so they get regenerated on the worker pool and then stitched together in execution order on this thread, the output is byte for byte what the serial path produces
+    void 
+        ExecutionParser::GenerateRootLevelScript()
+    {
+        if (pm_CurrentScriptRevision == pm_GraphRevision) //every edit, flag and reorder bumps the revision, so an unchanged graph reuses the last script as is
+        {
+            return;
+        }
+
+        WorkerPool& f_WorkerPool = WorkerPool::Pool();
+
+        if (pm_WorkerScratch.size() < f_WorkerPool.GetThreadCount())
+        {
+            pm_WorkerScratch.resize(f_WorkerPool.GetThreadCount());
+        }
+
+        pm_RootSourceMaps.clear();
+
+        for (const BlockNode* l_Root : pm_RootLevelBlockNodeExecutionOrder) //map lookups (and inserts) stay on this thread, workers only get handed their own root's map
+        {
+            pm_RootSourceMaps.push_back(&pm_TopLevelSourceMaps[l_Root->m_ID.m_Index]);
+        }
+
+        FindTopLevelScriptDonors();
+
+        f_WorkerPool.ParallelFor
+        (
+            pm_RootLevelBlockNodeExecutionOrder.size(),
+            [this](const size_t fp_RootIndex, const size_t fp_ThreadIndex)
+            {
+                if (pm_RootScriptDonors[fp_RootIndex] == NO_SCRIPT_DONOR)
+                {
+                    RefreshTopLevelScriptCache(pm_RootLevelBlockNodeExecutionOrder[fp_RootIndex], *pm_RootSourceMaps[fp_RootIndex], pm_WorkerScratch[fp_ThreadIndex]);
+                }
+            }
+        );
+
+        for (size_t l_RootIndex = 0; l_RootIndex < pm_RootLevelBlockNodeExecutionOrder.size(); l_RootIndex++) //donors are all up to date now
+        {
+            const size_t f_DonorIndex = pm_RootScriptDonors[l_RootIndex];
+
+            if (f_DonorIndex != NO_SCRIPT_DONOR and not ShareTopLevelScriptCache(f_DonorIndex, l_RootIndex))
+            {
+                RefreshTopLevelScriptCache(pm_RootLevelBlockNodeExecutionOrder[l_RootIndex], *pm_RootSourceMaps[l_RootIndex], pm_IncrementalScratch);
+            }
+        }
+
+        size_t f_TotalSize = 0;
+        size_t f_TotalSourceMapEntries = 0;
+
+        for (size_t l_RootIndex = 0; l_RootIndex < pm_RootLevelBlockNodeExecutionOrder.size(); l_RootIndex++)
+        {
+            f_TotalSize += pm_RootLevelBlockNodeExecutionOrder[l_RootIndex]->m_CachedScript.size();
+            f_TotalSourceMapEntries += pm_RootSourceMaps[l_RootIndex]->Size();
+        }
+
+        pm_CurrentScript.Clear();
+        pm_CurrentScript.Reserve(f_TotalSize);
+        pm_CurrentSourceMap.Clear();
+        pm_CurrentSourceMap.Reserve(f_TotalSourceMapEntries);
+
+        uint32_t f_Line = 0;
+
+        for (size_t l_RootIndex = 0; l_RootIndex < pm_RootLevelBlockNodeExecutionOrder.size(); l_RootIndex++)
+        {
+            BlockNode* f_Root = pm_RootLevelBlockNodeExecutionOrder[l_RootIndex];
+            f_Root->m_LineNumber = static_cast<int>(f_Line) + 1;
+
+            pm_CurrentScript.Append(f_Root->m_CachedScript);
+            pm_CurrentSourceMap.AppendShifted(*pm_RootSourceMaps[l_RootIndex], 0, pm_RootSourceMaps[l_RootIndex]->Size(), f_Line);
+            f_Line += f_Root->m_CachedLineCount;
+        }
+
+        const string_view f_Script = pm_CurrentScript.View();
+        pm_CurrentSourceMap.SetLineCount(f_Line + (not f_Script.empty() and f_Script.back() != '\n' ? 1 : 0));
+
+        pm_CurrentScriptHash = HashScript(pm_CurrentScript.View());
+        pm_CurrentScriptRevision = pm_GraphRevision;
+    }
+
+
+    string_view 
+        ExecutionParser::GenerateFullScript()
+    {
+        GenerateRootLevelScript();
+        return pm_CurrentScript.View();
+    }
+
+
+    uint64_t 
+        ExecutionParser::GetCurrentScriptHash() 
+        const
+    {
+        return pm_CurrentScriptHash;
+    }
+
+
+    //Every top level cache was built for the old passes, so all of them get thrown away (which also resets the per node splice bookkeeping optimized codegen doesn't keep)
+    void 
+        ExecutionParser::SetScriptOptimizationPasses(const ScriptOptimizationPasses fp_Passes)
+    {
+        if (fp_Passes == pm_ScriptOptimizationPasses) { return; }
+
+        pm_ScriptOptimizationPasses = fp_Passes;
+
+        for (BlockNode* l_BlockNode : pm_AllCurrentlyPlacedBlockNodes)
+        {
+            InvalidateBlockNodeSubtreeScripts(l_BlockNode);
+        }
+
+        MarkGraphDirty();
+    }
+
+
+    ScriptOptimizationPasses 
+        ExecutionParser::GetScriptOptimizationPasses() 
+        const
+    {
+        return pm_ScriptOptimizationPasses;
+    }
+
+
+    const ScriptSourceMap& 
+        ExecutionParser::GetCurrentSourceMap() 
+        const
+    {
+        return pm_CurrentSourceMap;
+    }
+
+
+    //Handles of nodes removed since the script was generated come back stale, so check them with IsBlockNodeHandleValid() before use
+    BlockNodeHandle 
+        ExecutionParser::FindBlockNodeAtScriptLine(const uint32_t fp_LineNumber) 
+        const
+    {
+        return pm_CurrentSourceMap.FindBlockNodeAtLine(fp_LineNumber);
+    }
+
+
+    //Re-emits only dirty nodes, clean subtrees get copied out of the previous run's text (and source map) in one go using their cached offsets and lengths
+    void 
+        ExecutionParser::EmitIncrementally(BlockNode* fp_TopLevelBlockNode, IncrementalEmission& fp_Emission, BlockNodeTraversal& fp_Traversal)
+    {
+        ScriptSink& f_Sink = fp_Emission.m_Sink;
+        vector<IncrementalEmissionFrame>& f_Frames = fp_Emission.m_Frames;
+
+        f_Frames.clear();
+        f_Frames.push_back({}); //stands in for the top level node's parent, everything is relative to the start of the script
+
+        fp_Traversal.Walk
+        (
+            fp_TopLevelBlockNode,
+            [&](BlockNode* fp_Node, const unsigned int fp_Depth)
+            {
+                IncrementalEmissionFrame& f_Parent = f_Frames.back();
+
+                const size_t f_PreviousStart = f_Parent.m_PreviousStart + fp_Node->m_CachedScriptOffset;
+                const size_t f_PreviousEntry = f_Parent.m_PreviousEntry + fp_Node->m_CachedSourceMapOffset;
+                const size_t f_Start = f_Sink.Size();
+                const size_t f_Entry = fp_Emission.m_SourceMap.Size();
+
+                fp_Node->m_CachedScriptOffset = f_Start - f_Parent.m_Start; //descendants are relative to us, so they stay valid untouched
+                fp_Node->m_CachedSourceMapOffset = f_Entry - f_Parent.m_Entry;
+
+                if (not fp_Node->m_IsScriptDirty and fp_Node->m_CachedScriptDepth == fp_Depth)
+                {
+                    f_Sink.Append(string_view(fp_Emission.m_PreviousScript).substr(f_PreviousStart, fp_Node->m_CachedScriptLength));
+                    fp_Emission.m_SourceMap.AppendShifted(fp_Emission.m_PreviousSourceMap, f_PreviousEntry, fp_Node->m_CachedSubtreeNodeCount, fp_Emission.m_Line);
+                    fp_Emission.m_Line += fp_Node->m_CachedLineCount;
+
+                    f_Parent.m_LineCount += fp_Node->m_CachedLineCount;
+                    f_Parent.m_NodeCount += fp_Node->m_CachedSubtreeNodeCount;
+                    return BlockNodeVisit::SkipChildren;
+                }
+
+                fp_Emission.m_SourceMap.Append(fp_Emission.m_Line, fp_Node->m_ID);
+                fp_Node->EmitScript(f_Sink, fp_Depth);
+
+                const string_view f_OwnText = f_Sink.View().substr(f_Start);
+                const unsigned int f_LineCount = static_cast<unsigned int>(count(f_OwnText.begin(), f_OwnText.end(), '\n'));
+
+                fp_Emission.m_Line += f_LineCount;
+
+                f_Frames.push_back({ f_PreviousStart, f_Start, f_PreviousEntry, f_Entry, f_LineCount, 1 }); //f_Parent is dangling from here on
+                return BlockNodeVisit::Continue;
+            },
+            [&](BlockNode* fp_Node, const unsigned int fp_Depth)
+            {
+                const IncrementalEmissionFrame f_Frame = f_Frames.back();
+                f_Frames.pop_back();
+
+                fp_Node->m_CachedScriptLength = f_Sink.Size() - f_Frame.m_Start;
+                fp_Node->m_CachedScriptDepth = fp_Depth;
+                fp_Node->m_CachedLineCount = f_Frame.m_LineCount;
+                fp_Node->m_CachedSubtreeNodeCount = f_Frame.m_NodeCount;
+                fp_Node->m_IsScriptDirty = false;
+
+                f_Frames.back().m_LineCount += f_Frame.m_LineCount;
+                f_Frames.back().m_NodeCount += f_Frame.m_NodeCount;
+            }
+        );
+    }
+
+
+    const FlattenedBlockNodeTree* 
+        ExecutionParser::CompileBlockNodeTree(const BlockNodeHandle fp_RootID)
+    {
+        const BlockNode* f_Root = FindBlockNode(fp_RootID);
+
+        if (!f_Root) { return nullptr; }
+
+        const BlockNode* f_TopLevelBlockNode = f_Root; //its stamp covers every snapshot taken anywhere below it
+
+        for (const BlockNode* l_Ancestor = FindBlockNode(f_Root->m_ParentID); l_Ancestor; l_Ancestor = FindBlockNode(l_Ancestor->m_ParentID))
+        {
+            f_TopLevelBlockNode = l_Ancestor;
+        }
+
+        FlattenedBlockNodeTree& f_FlattenedTree = pm_FlattenedBlockNodeTrees[fp_RootID.m_Index];
+
+        if (f_FlattenedTree.IsUpToDate(fp_RootID, f_TopLevelBlockNode->m_SnapshotRevision)) //edits under other top level nodes (or flag toggles) leave this one alone
+        {
+            return &f_FlattenedTree;
+        }
+
+        f_FlattenedTree.Build(f_Root, f_TopLevelBlockNode->m_SnapshotRevision);
+        pm_SnapshotEpoch++; //MarkBlockNodeDirty() stops at the first flagged ancestor, clearing every flag makes the next edit below this root walk all the way up and restamp
+
+        return &f_FlattenedTree;
+    }
+
+
+    void 
+        ExecutionParser::MarkGraphDirty()
+    {
+        pm_GraphRevision++;
+    }
+
+
+    void 
+        ExecutionParser::MarkBlockNodeDirty(const BlockNodeHandle fp_BlockNodeID)
+    {
+        MarkBlockNodeDirty(FindBlockNode(fp_BlockNodeID));
+    }
+
+
+    //////////////////////////////////////////////
+    // Subtree Hashing
+    //////////////////////////////////////////////
+
+    uint64_t 
+        ExecutionParser::GetBlockNodeSubtreeHash(const BlockNodeHandle fp_BlockNodeID)
+    {
+        BlockNode* f_BlockNode = FindBlockNode(fp_BlockNodeID);
+        return f_BlockNode ? UpdateBlockNodeSubtreeHash(f_BlockNode, pm_Traversal) : 0;
+    }
+
+
+    //Cached per graph revision, so asking again without an edit in between is O(1) and an edit only rehashes its own path
+    uint64_t 
+        ExecutionParser::GetGraphHash()
+    {
+        if (pm_GraphHashRevision == pm_GraphRevision)
+        {
+            return pm_GraphHash;
+        }
+
+        uint64_t f_Hash = CombineHashes(SCRIPT_HASH_SEED, static_cast<uint64_t>(pm_ScriptOptimizationPasses));
+
+        for (BlockNode* l_Root : pm_RootLevelBlockNodeExecutionOrder)
+        {
+            f_Hash = CombineHashes(f_Hash, UpdateBlockNodeSubtreeHash(l_Root, pm_Traversal));
+        }
+
+        pm_GraphHash = f_Hash;
+        pm_GraphHashRevision = pm_GraphRevision;
+
+        return f_Hash;
+    }
+
+
+    bool 
+        ExecutionParser::HasGraphChangedSinceLastRun()
+    {
+        return GetGraphHash() != pm_LastRunGraphHash;
+    }
+
+
+    //Post order over the dirty part only, an edit costs O(depth * siblings) to rehash since everything off the dirty path is reused as is
+    uint64_t 
+        ExecutionParser::UpdateBlockNodeSubtreeHash(BlockNode* fp_BlockNode, BlockNodeTraversal& fp_Traversal)
+    {
+        fp_Traversal.Walk
+        (
+            fp_BlockNode,
+            [](BlockNode* fp_Node, const unsigned int)
+            {
+                if (not fp_Node->m_IsSubtreeHashDirty)
+                {
+                    return BlockNodeVisit::SkipChildren;
+                }
+
+                fp_Node->m_IsSubtreeHashDirty = false; //cleared on the way down, a cycle in a broken graph then reuses a stale hash instead of looping forever
+                return BlockNodeVisit::Continue;
+            },
+            [](BlockNode* fp_Node, const unsigned int)
+            {
+                uint64_t f_Hash = CombineHashes(SCRIPT_HASH_SEED, static_cast<uint64_t>(fp_Node->m_Kind));
+                f_Hash = CombineHashes(HashScript(fp_Node->m_Name, f_Hash), fp_Node->m_Name.size()); //lengths keep "ab" + "c" apart from "a" + "bc"
+                f_Hash = CombineHashes(HashScript(fp_Node->m_CodeSnippet, f_Hash), fp_Node->m_CodeSnippet.size());
+
+                for (const BlockNode* l_Child : fp_Node->m_Children)
+                {
+                    f_Hash = CombineHashes(f_Hash, l_Child->m_SubtreeHash);
+                }
+
+                fp_Node->m_SubtreeHash = CombineHashes(f_Hash, fp_Node->m_Children.size());
+            }
+        );
+
+        return fp_BlockNode->m_SubtreeHash;
+    }
+
+
+    //Copy pasted roots come out of codegen as the exact same text, so only the first of a group gets generated and the rest copy it.
+    //A root only gets its whole subtree hashed once its own kind, text and child count match another root's, which almost never happens
+    //outside of actual copies, so cold codegen doesn't pay for a second pass over all the text. Clean roots are preferred as donors since
+    //their text is already there
+    void 
+        ExecutionParser::FindTopLevelScriptDonors()
+    {
+        const vector<BlockNode*>& f_Roots = pm_RootLevelBlockNodeExecutionOrder;
+        pm_RootScriptDonors.assign(f_Roots.size(), NO_SCRIPT_DONOR);
+
+        if (f_Roots.size() < 2)
+        {
+            return;
+        }
+
+        const auto f_GetShallowKey = [](const BlockNode* fp_Root)
+            {
+                const uint64_t f_Hash = HashScript(fp_Root->m_CodeSnippet, HashScript(fp_Root->m_Name, CombineHashes(SCRIPT_HASH_SEED, static_cast<uint64_t>(fp_Root->m_Kind))));
+                return CombineHashes(f_Hash, (fp_Root->m_Name.size() << 32) ^ fp_Root->m_CodeSnippet.size() ^ (fp_Root->m_Children.size() << 48));
+            };
+
+        pm_RootShallowKeys.clear();
+        pm_RootShallowKeyCounts.clear();
+
+        for (const BlockNode* l_Root : f_Roots)
+        {
+            pm_RootShallowKeys.push_back(f_GetShallowKey(l_Root));
+
+            if (l_Root->m_IsScriptDirty)
+            {
+                pm_RootShallowKeyCounts[pm_RootShallowKeys.back()]++;
+            }
+        }
+
+        if (pm_RootShallowKeyCounts.empty())
+        {
+            return;
+        }
+
+        pm_RootScriptDonorCandidates.clear();
+
+        for (size_t l_RootIndex = 0; l_RootIndex < f_Roots.size(); l_RootIndex++) //clean roots only count if some dirty root looks like them
+        {
+            if (not f_Roots[l_RootIndex]->m_IsScriptDirty)
+            {
+                const auto f_Count = pm_RootShallowKeyCounts.find(pm_RootShallowKeys[l_RootIndex]);
+
+                if (f_Count != pm_RootShallowKeyCounts.end())
+                {
+                    f_Count->second++;
+                }
+            }
+        }
+
+        for (size_t l_RootIndex = 0; l_RootIndex < f_Roots.size(); l_RootIndex++) //second pass keeps the candidates in execution order
+        {
+            const auto f_Count = pm_RootShallowKeyCounts.find(pm_RootShallowKeys[l_RootIndex]);
+
+            if (f_Count != pm_RootShallowKeyCounts.end() and f_Count->second > 1)
+            {
+                pm_RootScriptDonorCandidates.push_back(l_RootIndex);
+            }
+        }
+
+        if (pm_RootScriptDonorCandidates.empty())
+        {
+            return;
+        }
+
+        WorkerPool::Pool().ParallelFor
+        (
+            pm_RootScriptDonorCandidates.size(),
+            [this, &f_Roots](const size_t fp_CandidateIndex, const size_t fp_ThreadIndex)
+            {
+                UpdateBlockNodeSubtreeHash(f_Roots[pm_RootScriptDonorCandidates[fp_CandidateIndex]], pm_WorkerScratch[fp_ThreadIndex].m_Traversal);
+            }
+        );
+
+        pm_RootIndicesBySubtreeHash.clear();
+
+        for (const size_t l_RootIndex : pm_RootScriptDonorCandidates)
+        {
+            if (not f_Roots[l_RootIndex]->m_IsScriptDirty)
+            {
+                pm_RootIndicesBySubtreeHash.try_emplace(f_Roots[l_RootIndex]->m_SubtreeHash, l_RootIndex);
+            }
+        }
+
+        for (const size_t l_RootIndex : pm_RootScriptDonorCandidates)
+        {
+            if (f_Roots[l_RootIndex]->m_IsScriptDirty)
+            {
+                const auto [f_Donor, f_IsFirst] = pm_RootIndicesBySubtreeHash.try_emplace(f_Roots[l_RootIndex]->m_SubtreeHash, l_RootIndex);
+
+                if (not f_IsFirst)
+                {
+                    pm_RootScriptDonors[l_RootIndex] = f_Donor->second;
+                }
+            }
+        }
+    }
+
+
+    //Both subtrees get compared node by node before anything is written, so a hash collision just means the recipient gets generated normally
+    bool 
+        ExecutionParser::ShareTopLevelScriptCache(const size_t fp_DonorIndex, const size_t fp_RecipientIndex)
+    {
+        BlockNode* f_Donor = pm_RootLevelBlockNodeExecutionOrder[fp_DonorIndex];
+        BlockNode* f_Recipient = pm_RootLevelBlockNodeExecutionOrder[fp_RecipientIndex];
+
+        pm_SharedBlockNodePairs.clear();
+        pm_SharedBlockNodePairs.push_back({ f_Donor, f_Recipient });
+
+        for (size_t l_Pair = 0; l_Pair < pm_SharedBlockNodePairs.size(); l_Pair++) //breadth first, the pairs list doubles as the queue
+        {
+            const auto [f_DonorNode, f_RecipientNode] = pm_SharedBlockNodePairs[l_Pair];
+
+            if (f_DonorNode->m_Kind != f_RecipientNode->m_Kind or f_DonorNode->m_Children.size() != f_RecipientNode->m_Children.size()
+                or f_DonorNode->m_Name != f_RecipientNode->m_Name or f_DonorNode->m_CodeSnippet != f_RecipientNode->m_CodeSnippet)
+            {
+                return false;
+            }
+
+            for (size_t l_Child = 0; l_Child < f_DonorNode->m_Children.size(); l_Child++)
+            {
+                pm_SharedBlockNodePairs.push_back({ f_DonorNode->m_Children[l_Child], f_RecipientNode->m_Children[l_Child] });
+            }
+        }
+
+        if (pm_SharedBlockNodeIDs.size() < pm_BlockNodeSlotMap.SlotCount())
+        {
+            pm_SharedBlockNodeIDs.resize(pm_BlockNodeSlotMap.SlotCount());
+        }
+
+        for (const auto& [l_DonorNode, l_RecipientNode] : pm_SharedBlockNodePairs) //same text, same position relative to the parent, so every per node cache carries over unchanged
+        {
+            l_RecipientNode->m_CachedScriptDepth = l_DonorNode->m_CachedScriptDepth;
+            l_RecipientNode->m_CachedLineCount = l_DonorNode->m_CachedLineCount;
+            l_RecipientNode->m_CachedSubtreeNodeCount = l_DonorNode->m_CachedSubtreeNodeCount;
+            l_RecipientNode->m_CachedSourceMapOffset = l_DonorNode->m_CachedSourceMapOffset;
+            l_RecipientNode->m_CachedScriptOffset = l_DonorNode->m_CachedScriptOffset;
+            l_RecipientNode->m_CachedScriptLength = l_DonorNode->m_CachedScriptLength;
+
+            pm_SharedBlockNodeIDs[l_DonorNode->m_ID.m_Index] = l_RecipientNode->m_ID;
+        }
+
+        f_Recipient->m_CachedScript = f_Donor->m_CachedScript;
+        pm_RootSourceMaps[fp_RecipientIndex]->AssignRemapped
+        (
+            *pm_RootSourceMaps[fp_DonorIndex],
+            [this](const BlockNodeHandle fp_DonorID) { return pm_SharedBlockNodeIDs[fp_DonorID.m_Index]; }
+        );
+
+        MarkBlockNodeSubtreeClean(f_Recipient, pm_Traversal);
+        return true;
+    }
+
+
+    //////////////////////////////////////////////
+    // Edit History
+    //////////////////////////////////////////////
+
+    bool 
+        ExecutionParser::Undo()
+    {
+        if (pm_EditHistoryCursor == pm_EditHistoryFront) { return false; }
+
+        const uint64_t f_Step = pm_EditHistory[pm_EditHistoryCursor - 1].m_Step;
+        pm_IsReplayingEdits = true;
+
+        while (pm_EditHistoryCursor > pm_EditHistoryFront and pm_EditHistory[pm_EditHistoryCursor - 1].m_Step == f_Step) //newest first, each command sees the graph exactly as it left it
+        {
+            ApplyEditCommand(pm_EditHistory[--pm_EditHistoryCursor]);
+        }
+
+        pm_IsReplayingEdits = false;
+        return true;
+    }
+
+
+    bool 
+        ExecutionParser::Redo()
+    {
+        if (pm_EditHistoryCursor == pm_EditHistory.size()) { return false; }
+
+        const uint64_t f_Step = pm_EditHistory[pm_EditHistoryCursor].m_Step;
+        pm_IsReplayingEdits = true;
+
+        while (pm_EditHistoryCursor < pm_EditHistory.size() and pm_EditHistory[pm_EditHistoryCursor].m_Step == f_Step)
+        {
+            ApplyEditCommand(pm_EditHistory[pm_EditHistoryCursor++]);
+        }
+
+        pm_IsReplayingEdits = false;
+        return true;
+    }
+
+
+    bool 
+        ExecutionParser::CanUndo()
+        const
+    {
+        return pm_EditHistoryCursor > pm_EditHistoryFront;
+    }
+
+
+    bool 
+        ExecutionParser::CanRedo()
+        const
+    {
+        return pm_EditHistoryCursor < pm_EditHistory.size();
+    }
+
+
+    void 
+        ExecutionParser::BeginEditStep()
+    {
+        if (pm_EditStepDepth++ == 0)
+        {
+            pm_OpenEditStep = pm_NextEditStep++;
+        }
+    }
+
+
+    void 
+        ExecutionParser::EndEditStep()
+    {
+        if (pm_EditStepDepth > 0)
+        {
+            pm_EditStepDepth--;
+        }
+    }
+
+
+    void 
+        ExecutionParser::SetUndoHistoryLimit(const size_t fp_StepCount)
+    {
+        pm_UndoHistoryLimit = fp_StepCount;
+
+        if (fp_StepCount == 0)
+        {
+            ClearEditHistory();
+            return;
+        }
+
+        while (pm_EditHistoryStepCount > pm_UndoHistoryLimit and pm_EditHistoryCursor > pm_EditHistoryFront) //steps that could still be redone stay, they go once the next edit comes in
+        {
+            DropOldestEditStep();
+        }
+    }
+
+
+    void 
+        ExecutionParser::ClearEditHistory()
+    {
+        for (size_t l_Index = pm_EditHistoryFront; l_Index < pm_EditHistory.size(); l_Index++)
+        {
+            DropEditCommand(pm_EditHistory[l_Index]);
+        }
+
+        pm_EditHistory.clear();
+        pm_EditHistoryFront = 0;
+        pm_EditHistoryCursor = 0;
+        pm_EditHistoryStepCount = 0;
+    }
+
+
+    bool 
+        ExecutionParser::IsRecordingEdits()
+        const
+    {
+        return pm_UndoHistoryLimit != 0 and not pm_IsReplayingEdits;
+    }
+
+
+    //Anything that could still be redone was built on top of the state this edit just replaced, so it goes first
+    void 
+        ExecutionParser::RecordEdit(EditCommand&& fp_Command)
+    {
+        if (not IsRecordingEdits()) 
+        { 
+            DropEditCommand(fp_Command); 
+            return; 
+        }
+
+        DropRedoableEditCommands();
+
+        fp_Command.m_Step = pm_EditStepDepth > 0 ? pm_OpenEditStep : pm_NextEditStep++;
+
+        if (pm_EditHistory.size() == pm_EditHistoryFront or pm_EditHistory.back().m_Step != fp_Command.m_Step)
+        {
+            pm_EditHistoryStepCount++;
+        }
+
+        pm_EditHistory.push_back(move(fp_Command));
+        pm_EditHistoryCursor = pm_EditHistory.size();
+
+        while (pm_EditHistoryStepCount > pm_UndoHistoryLimit)
+        {
+            DropOldestEditStep();
+        }
+    }
+
+
+    void 
+        ExecutionParser::RecordPlacementEdit(const BlockNode* fp_BlockNode, const BlockNodePlacement& fp_PreviousPlacement)
+    {
+        if (not IsRecordingEdits()) { return; }
+
+        const bool f_IsUnchanged = fp_PreviousPlacement.m_ParentID == fp_BlockNode->m_ParentID //cheap fields first, most edits change one of them
+            and fp_PreviousPlacement.m_InputLineNumber == fp_BlockNode->m_InputLineNumber
+            and fp_PreviousPlacement.m_IsRootExecutable == fp_BlockNode->m_IsRootExecutable
+            and fp_PreviousPlacement == CaptureBlockNodePlacement(fp_BlockNode);
+
+        if (not f_IsUnchanged) //setting the line number a node already has isn't worth an undo step
+        {
+            RecordEdit({ EditCommandKind::Placement, fp_BlockNode->m_ID, 0, fp_PreviousPlacement });
+        }
+    }
+
+
+    void 
+        ExecutionParser::ApplyEditCommand(EditCommand& fp_Command)
+    {
+        if (fp_Command.m_Kind == EditCommandKind::Liveness and fp_Command.m_RetainedBlockNode) //retired nodes can't be looked up, the command holds the only reference
+        {
+            BlockNode* f_BlockNode = exchange(fp_Command.m_RetainedBlockNode, nullptr);
+
+            ReviveBlockNodeSubtree(f_BlockNode);
+            PlaceBlockNode(f_BlockNode, fp_Command.m_OtherPlacement);
+            return;
+        }
+
+        BlockNode* f_BlockNode = FindBlockNode(fp_Command.m_ID);
+
+        if (!f_BlockNode) //only possible if someone edited around the history, eg. through MarkBlockNodeDirty()
+        {
+            PrintError(format("Edit history is out of sync with the graph, block node {} is gone", fp_Command.m_ID.m_Index));
+            return;
+        }
+
+        switch (fp_Command.m_Kind)
+        {
+        case EditCommandKind::Liveness:
+            fp_Command.m_OtherPlacement = CaptureBlockNodePlacement(f_BlockNode);
+            DetachBlockNodeFromParent(f_BlockNode);
+            RetireBlockNodeSubtree(f_BlockNode);
+            fp_Command.m_RetainedBlockNode = f_BlockNode;
+            MarkGraphDirty();
+            break;
+
+        case EditCommandKind::Placement:
+            SwapBlockNodePlacement(f_BlockNode, fp_Command.m_OtherPlacement);
+            break;
+
+        case EditCommandKind::Name:
+            swap(f_BlockNode->m_Name, fp_Command.m_OtherText);
+            MarkBlockNodeDirty(f_BlockNode);
+            break;
+
+        case EditCommandKind::CodeSnippet:
+            swap(f_BlockNode->m_CodeSnippet, fp_Command.m_OtherText);
+            MarkBlockNodeDirty(f_BlockNode);
+            break;
+        }
+    }
+
+
+    void 
+        ExecutionParser::DropEditCommand(EditCommand& fp_Command)
+    {
+        if (fp_Command.m_RetainedBlockNode) //nothing can bring this branch back anymore
+        {
+            DestroyRetiredBlockNodeSubtree(exchange(fp_Command.m_RetainedBlockNode, nullptr));
+        }
+    }
+
+
+    void 
+        ExecutionParser::DropRedoableEditCommands()
+    {
+        while (pm_EditHistory.size() > pm_EditHistoryCursor)
+        {
+            const uint64_t f_Step = pm_EditHistory.back().m_Step;
+
+            DropEditCommand(pm_EditHistory.back());
+            pm_EditHistory.pop_back();
+
+            if (pm_EditHistory.size() == pm_EditHistoryFront or pm_EditHistory.back().m_Step != f_Step)
+            {
+                pm_EditHistoryStepCount--;
+            }
+        }
+    }
+
+
+    void 
+        ExecutionParser::DropOldestEditStep()
+    {
+        const uint64_t f_Step = pm_EditHistory[pm_EditHistoryFront].m_Step;
+
+        while (pm_EditHistoryFront < pm_EditHistory.size() and pm_EditHistory[pm_EditHistoryFront].m_Step == f_Step)
+        {
+            DropEditCommand(pm_EditHistory[pm_EditHistoryFront++]);
+        }
+
+        pm_EditHistoryStepCount--;
+
+        if (pm_EditHistoryFront >= 1024 and pm_EditHistoryFront * 2 >= pm_EditHistory.size()) //amortized O(1) per dropped command, and no allocation per edit like a deque of these would do
+        {
+            pm_EditHistory.erase(pm_EditHistory.begin(), pm_EditHistory.begin() + pm_EditHistoryFront);
+            pm_EditHistoryCursor -= pm_EditHistoryFront;
+            pm_EditHistoryFront = 0;
+        }
+    }
+
+
+    //O(siblings), the same search DetachBlockNodeFromParent() does anyway
+    BlockNodePlacement 
+        ExecutionParser::CaptureBlockNodePlacement(const BlockNode* fp_BlockNode)
+        const
+    {
+        const BlockNode* f_Parent = FindBlockNode(fp_BlockNode->m_ParentID);
+        const vector<BlockNode*>& f_Siblings = f_Parent ? f_Parent->m_Children : pm_AllCurrentlyPlacedBlockNodes;
+
+        BlockNodePlacement f_Placement;
+        f_Placement.m_ParentID = fp_BlockNode->m_ParentID;
+        f_Placement.m_InputLineNumber = fp_BlockNode->m_InputLineNumber;
+        f_Placement.m_IsRootExecutable = fp_BlockNode->m_IsRootExecutable;
+
+        const auto f_Sibling = find(f_Siblings.rbegin(), f_Siblings.rend(), fp_BlockNode);
+        f_Placement.m_SiblingIndex = f_Sibling == f_Siblings.rend() ? 0 : static_cast<uint32_t>(f_Siblings.rend() - f_Sibling - 1);
+
+        if (fp_BlockNode->m_IsRootExecutable and not f_Parent)
+        {
+            const auto f_Entry = const_cast<ExecutionParser*>(this)->FindInRootLevelBlockNodeExecutionOrder(fp_BlockNode);
+
+            if (f_Entry != pm_RootLevelBlockNodeExecutionOrder.end())
+            {
+                f_Placement.m_ExecutionIndex = static_cast<uint32_t>(f_Entry - pm_RootLevelBlockNodeExecutionOrder.begin());
+            }
+        }
+
+        return f_Placement;
+    }
+
+
+    //Flag and line number changes only touch the execution order, the node itself only moves (and loses its cached text) when it changes parents
+    void 
+        ExecutionParser::SwapBlockNodePlacement(BlockNode* fp_BlockNode, BlockNodePlacement& fp_Placement)
+    {
+        const BlockNodePlacement f_CurrentPlacement = CaptureBlockNodePlacement(fp_BlockNode);
+
+        if (f_CurrentPlacement.m_ParentID == fp_Placement.m_ParentID and f_CurrentPlacement.m_SiblingIndex == fp_Placement.m_SiblingIndex)
+        {
+            if (f_CurrentPlacement.m_ExecutionIndex != BlockNodePlacement::NOT_IN_EXECUTION_ORDER)
+            {
+                pm_RootLevelBlockNodeExecutionOrder.erase(pm_RootLevelBlockNodeExecutionOrder.begin() + f_CurrentPlacement.m_ExecutionIndex);
+            }
+
+            fp_BlockNode->m_InputLineNumber = fp_Placement.m_InputLineNumber;
+            fp_BlockNode->m_IsRootExecutable = fp_Placement.m_IsRootExecutable;
+
+            if (fp_Placement.m_ExecutionIndex != BlockNodePlacement::NOT_IN_EXECUTION_ORDER)
+            {
+                pm_RootLevelBlockNodeExecutionOrder.insert(pm_RootLevelBlockNodeExecutionOrder.begin() + min<size_t>(fp_Placement.m_ExecutionIndex, pm_RootLevelBlockNodeExecutionOrder.size()), fp_BlockNode);
+            }
+
+            MarkGraphDirty();
+        }
+        else
+        {
+            DetachBlockNodeFromParent(fp_BlockNode);
+            PlaceBlockNode(fp_BlockNode, fp_Placement);
+        }
+
+        fp_Placement = f_CurrentPlacement;
+    }
+
+
+    void 
+        ExecutionParser::PlaceBlockNode(BlockNode* fp_BlockNode, const BlockNodePlacement& fp_Placement)
     {
-        string f_PythonScript;
-        DFS(fp_StartingBlockNode, 0, f_PythonScript);
-        //PeachCore::LogManager::Logger().Debug(" ", "ExecutionParser");
-        return f_PythonScript;
+        BlockNode* f_Parent = FindBlockNode(fp_Placement.m_ParentID);
+        vector<BlockNode*>& f_Siblings = f_Parent ? f_Parent->m_Children : pm_AllCurrentlyPlacedBlockNodes;
+        vector<BlockNodeHandle>& f_SiblingIDs = f_Parent ? f_Parent->m_ChildIDs : pm_AllCurrentlyPlacedBlockNodeIDs;
+        const size_t f_SiblingIndex = min<size_t>(fp_Placement.m_SiblingIndex, f_Siblings.size());
+
+        f_Siblings.insert(f_Siblings.begin() + f_SiblingIndex, fp_BlockNode);
+        f_SiblingIDs.insert(f_SiblingIDs.begin() + f_SiblingIndex, fp_BlockNode->m_ID);
+
+        fp_BlockNode->m_ParentID = f_Parent ? fp_Placement.m_ParentID : BlockNodeHandle{};
+        fp_BlockNode->m_InputLineNumber = fp_Placement.m_InputLineNumber;
+        fp_BlockNode->m_IsRootExecutable = fp_Placement.m_IsRootExecutable;
+
+        if (fp_Placement.m_ExecutionIndex != BlockNodePlacement::NOT_IN_EXECUTION_ORDER)
+        {
+            pm_RootLevelBlockNodeExecutionOrder.insert(pm_RootLevelBlockNodeExecutionOrder.begin() + min<size_t>(fp_Placement.m_ExecutionIndex, pm_RootLevelBlockNodeExecutionOrder.size()), fp_BlockNode);
+        }
+
+        InvalidateBlockNodeSubtreeScripts(fp_BlockNode); //cached offsets were relative to wherever it hung before
+        MarkBlockNodeDirty(fp_BlockNode);
     }
 
-    //DFS used to build script when ready from root node BlockNodes, strategy is to iterate through all block nodes, run DFS on flagged block nodes
+
+    //Same walk as DestroyBlockNodeSubtree(), but the nodes and their m_Children stay as they are
     void 
-        ExecutionParser::DFS(const BlockNode* fp_Node, unsigned int fp_Depth, string& fp_Script) 
-        const
+        ExecutionParser::RetireBlockNodeSubtree(BlockNode* fp_BlockNode)
+    {
+        pm_Traversal.Walk
+        (
+            fp_BlockNode,
+            [](const BlockNode*, const unsigned int) {},
+            [this](const BlockNode* fp_Node, const unsigned int)
+            {
+                pm_FlattenedBlockNodeTrees.erase(fp_Node->m_ID.m_Index);
+                pm_TopLevelSourceMaps.erase(fp_Node->m_ID.m_Index);
+                pm_BlockNodeSlotMap.Retire(fp_Node->m_ID);
+            }
+        );
+    }
+
+
+    void 
+        ExecutionParser::ReviveBlockNodeSubtree(BlockNode* fp_BlockNode)
+    {
+        pm_Traversal.Walk(fp_BlockNode, [this](BlockNode* fp_Node, const unsigned int) { pm_BlockNodeSlotMap.Revive(fp_Node->m_ID, fp_Node); });
+    }
+
+
+    void 
+        ExecutionParser::DestroyRetiredBlockNodeSubtree(BlockNode* fp_BlockNode)
+    {
+        pm_Traversal.Walk
+        (
+            fp_BlockNode,
+            [](const BlockNode*, const unsigned int) {},
+            [this](BlockNode* fp_Node, const unsigned int)
+            {
+                pm_BlockNodeSlotMap.ReleaseRetired(fp_Node->m_ID);
+                pm_BlockNodeArena.Destroy(fp_Node);
+            }
+        );
+    }
+
+
+    //////////////////////////////////////////////
+    // Graph Validation
+    //////////////////////////////////////////////
+
+    //Top level nodes get split across the WorkerPool and each one walks its own subtree, the atomic visited bits are what catch nodes shared between walks.
+    //Whatever no walk reached gets explained afterwards by following its m_ParentID chain, which is also the only way to find cycles nothing points into
+    const GraphValidationReport& 
+        ExecutionParser::ValidateGraph()
     {
-        if (!fp_Node) { return; }
-        fp_Script += fp_Node->ToScript(fp_Depth);
+        if (pm_ValidationReport.m_GraphRevision == pm_GraphRevision)
+        {
+            return pm_ValidationReport;
+        }
+
+        WorkerPool& f_WorkerPool = WorkerPool::Pool();
+
+        if (pm_WorkerValidationScratch.size() < f_WorkerPool.GetThreadCount())
+        {
+            pm_WorkerValidationScratch.resize(f_WorkerPool.GetThreadCount());
+        }
+
+        for (ValidationScratch& l_Scratch : pm_WorkerValidationScratch)
+        {
+            l_Scratch.m_Diagnostics.clear();
+            l_Scratch.m_UnreachedBlockNodes.clear();
+        }
+
+        vector<GraphDiagnostic>& f_Diagnostics = pm_ValidationReport.m_Diagnostics;
+        f_Diagnostics.clear();
+
+        pm_ValidationVisited.Reset(pm_BlockNodeSlotMap.SlotCount());
+        pm_ValidationTopLevelBlockNodes.clear();
+
+        for (size_t l_TopLevelIndex = 0; l_TopLevelIndex < pm_AllCurrentlyPlacedBlockNodes.size(); l_TopLevelIndex++) //marked up front so a walk running into another top level node sees it as taken no matter which thread gets there first
+        {
+            BlockNode* f_BlockNode = pm_AllCurrentlyPlacedBlockNodes[l_TopLevelIndex];
+            const BlockNodeHandle f_ID = l_TopLevelIndex < pm_AllCurrentlyPlacedBlockNodeIDs.size() ? pm_AllCurrentlyPlacedBlockNodeIDs[l_TopLevelIndex] : BlockNodeHandle{};
+
+            if (!f_BlockNode or FindBlockNode(f_ID) != f_BlockNode) //same check as ValidateBlockNodeChildren(), the pointer only gets read once its handle is known to be live
+            {
+                f_Diagnostics.push_back({ GraphDiagnosticKind::DanglingChild, f_ID });
+                continue;
+            }
+
+            if (pm_ValidationVisited.TestAndSet(f_BlockNode->m_ID.m_Index))
+            {
+                f_Diagnostics.push_back({ GraphDiagnosticKind::DuplicateTopLevelNode, f_BlockNode->m_ID });
+                continue;
+            }
+
+            if (not f_BlockNode->m_ParentID.IsNull())
+            {
+                f_Diagnostics.push_back({ GraphDiagnosticKind::TopLevelNodeHasParent, f_BlockNode->m_ID, f_BlockNode->m_ParentID });
+            }
+
+            pm_ValidationTopLevelBlockNodes.push_back(f_BlockNode);
+        }
+
+        const BlockNode* f_PreviousRoot = nullptr;
+
+        for (const BlockNode* l_Root : pm_RootLevelBlockNodeExecutionOrder) //flagged roots get emitted back to back, so an else has to follow an if root just like a sibling would
+        {
+            AddIfChainDiagnostic(l_Root, f_PreviousRoot, f_Diagnostics);
+            f_PreviousRoot = l_Root;
+        }
+
+        f_WorkerPool.ParallelFor
+        (
+            pm_ValidationTopLevelBlockNodes.size(),
+            [this](const size_t fp_Index, const size_t fp_ThreadIndex)
+            {
+                ValidateBlockNodeSubtree(pm_ValidationTopLevelBlockNodes[fp_Index], pm_WorkerValidationScratch[fp_ThreadIndex]);
+            }
+        );
+
+        constexpr size_t VALIDATION_CHUNK_SIZE = 16'384; //slot map values per job, keeps the std::function call out of the per node cost
+        const size_t f_NodeCount = pm_BlockNodeSlotMap.Size();
+
+        f_WorkerPool.ParallelFor
+        (
+            (f_NodeCount + VALIDATION_CHUNK_SIZE - 1) / VALIDATION_CHUNK_SIZE,
+            [this, f_NodeCount](const size_t fp_Chunk, const size_t fp_ThreadIndex)
+            {
+                ValidationScratch& f_Scratch = pm_WorkerValidationScratch[fp_ThreadIndex];
+                const auto f_Begin = pm_BlockNodeSlotMap.begin() + fp_Chunk * VALIDATION_CHUNK_SIZE;
+                const auto f_End = pm_BlockNodeSlotMap.begin() + min(f_NodeCount, (fp_Chunk + 1) * VALIDATION_CHUNK_SIZE);
+
+                for (auto l_Value = f_Begin; l_Value != f_End; ++l_Value)
+                {
+                    BlockNode* f_BlockNode = *l_Value;
+
+                    if (!f_BlockNode) { continue; }
+
+                    if (FindBlockNode(f_BlockNode->m_ID) != f_BlockNode)
+                    {
+                        f_Scratch.m_Diagnostics.push_back({ GraphDiagnosticKind::DuplicateID, f_BlockNode->m_ID });
+                    }
+                    else if (not pm_ValidationVisited.Test(f_BlockNode->m_ID.m_Index))
+                    {
+                        f_Scratch.m_UnreachedBlockNodes.push_back(f_BlockNode);
+                    }
+                }
+            }
+        );
+
+        ValidateUnreachedBlockNodes();
 
-        for (const auto& child : fp_Node->m_Children) 
+        for (const ValidationScratch& l_Scratch : pm_WorkerValidationScratch)
         {
-            DFS(child.get(), fp_Depth + 1, fp_Script);  // child.get() returns a raw pointer
+            f_Diagnostics.insert(f_Diagnostics.end(), l_Scratch.m_Diagnostics.begin(), l_Scratch.m_Diagnostics.end());
         }
+
+        sort
+        (
+            f_Diagnostics.begin(), f_Diagnostics.end(),
+            [](const GraphDiagnostic& fp_Left, const GraphDiagnostic& fp_Right)
+            {
+                return tie(fp_Left.m_Kind, fp_Left.m_ID.m_Index, fp_Left.m_RelatedID.m_Index) < tie(fp_Right.m_Kind, fp_Right.m_ID.m_Index, fp_Right.m_RelatedID.m_Index);
+            }
+        );
+
+        pm_ValidationReport.m_CheckedNodeCount = f_NodeCount;
+        pm_ValidationReport.m_GraphRevision = pm_GraphRevision;
+
+        return pm_ValidationReport;
     }
 
-    //Searches a specific node reference's children all the way down to see if desire BlockNodeID is found, if not found it returns nullptr
-    BlockNode* 
-        ExecutionParser::DFSReturnSpecificBlockNodePointerReference(BlockNode* fp_BlockNode, const unsigned int fp_BlockNodeID)
+
+    //Iterative so a malformed graph (or just a very deep one) can't blow the worker's stack
+    void 
+        ExecutionParser::ValidateBlockNodeSubtree(BlockNode* fp_TopLevelBlockNode, ValidationScratch& fp_Scratch)
     {
-        if (!fp_BlockNode) { return nullptr; }
-        if (fp_BlockNode->m_ID == fp_BlockNodeID) { return fp_BlockNode; }
+        fp_Scratch.m_Stack.clear();
+        fp_Scratch.m_PendingBlockNodes.clear();
+
+        ValidateBlockNodeChildren(fp_TopLevelBlockNode, fp_Scratch);
 
-        for (const auto& child : fp_BlockNode->m_Children) 
+        while (not fp_Scratch.m_Stack.empty())
         {
-            BlockNode* result = DFSReturnSpecificBlockNodePointerReference(child.get(), fp_BlockNodeID);
-            if (result) { return result; }
+            ValidationScratch::Frame& f_Frame = fp_Scratch.m_Stack.back();
+
+            if (f_Frame.m_NextPending == f_Frame.m_PendingEnd)
+            {
+                fp_Scratch.m_PendingBlockNodes.resize(f_Frame.m_PendingStart); //everything past it belonged to frames that are already gone
+                fp_Scratch.m_Stack.pop_back();
+                continue;
+            }
+
+            ValidateBlockNodeChildren(fp_Scratch.m_PendingBlockNodes[f_Frame.m_NextPending++], fp_Scratch);
         }
-        return nullptr;
     }
 
-    //Iterates through list of all placed block nodes and applies DFSReturnBlockNodePointerReference() to each root block of the scene and returns nullptr if not found
-    BlockNode* 
-        ExecutionParser::DFSFindBlockNodeReferenceInTree(unsigned int fp_BlockNodeID, bool fp_IsLookingForRoot) 
+
+    //Every child gets checked in one loop before any of them is walked into, their loads don't depend on each other so the cache misses overlap instead of
+    //being paid one at a time, which is most of what a walk over a big graph costs
+    void 
+        ExecutionParser::ValidateBlockNodeChildren(BlockNode* fp_BlockNode, ValidationScratch& fp_Scratch)
     {
-        for (const auto& l_BlockNode : pm_AllCurrentlyPlacedBlockNodes)
+        const size_t f_PendingStart = fp_Scratch.m_PendingBlockNodes.size();
+        const vector<BlockNode*>& f_Children = fp_BlockNode->m_Children;
+        const vector<BlockNodeHandle>& f_ChildIDs = fp_BlockNode->m_ChildIDs;
+        const BlockNode* f_PreviousChild = nullptr;
+
+        for (size_t l_ChildIndex = 0; l_ChildIndex < f_Children.size(); l_ChildIndex++)
         {
-            if (!l_BlockNode->m_IsRootExecutable && fp_IsLookingForRoot) 
+            BlockNode* f_Child = f_Children[l_ChildIndex];
+            const BlockNodeHandle f_ChildID = l_ChildIndex < f_ChildIDs.size() ? f_ChildIDs[l_ChildIndex] : BlockNodeHandle{};
+
+            //a removed child's slot (and its memory in the arena) can already belong to a new node, so the pointer can't be trusted to say whose it is.
+            //The handle stored next to it can, its generation went stale the moment the child was removed
+            if (!f_Child or FindBlockNode(f_ChildID) != f_Child)
             {
+                fp_Scratch.m_Diagnostics.push_back({ GraphDiagnosticKind::DanglingChild, f_ChildID, fp_BlockNode->m_ID });
+                f_PreviousChild = nullptr; //keeps the next sibling's if chain check off of it
                 continue;
             }
 
-            BlockNode* result = DFSReturnSpecificBlockNodePointerReference(l_BlockNode.get(), fp_BlockNodeID);
+            if (f_Child->m_ParentID != fp_BlockNode->m_ID)
+            {
+                fp_Scratch.m_Diagnostics.push_back({ GraphDiagnosticKind::ParentMismatch, f_Child->m_ID, fp_BlockNode->m_ID });
+            }
+
+            AddIfChainDiagnostic(f_Child, f_PreviousChild, fp_Scratch.m_Diagnostics);
+            f_PreviousChild = f_Child;
 
-            if (result) 
+            if (pm_ValidationVisited.TestAndSet(f_Child->m_ID.m_Index)) //only broken graphs get here, so scanning the path is fine
             {
-                return result;
+                const bool f_IsOnPath = f_Child == fp_BlockNode or any_of
+                (
+                    fp_Scratch.m_Stack.begin(), fp_Scratch.m_Stack.end(),
+                    [f_Child](const ValidationScratch::Frame& fp_Frame) { return fp_Frame.m_BlockNode == f_Child; }
+                );
+
+                fp_Scratch.m_Diagnostics.push_back({ f_IsOnPath ? GraphDiagnosticKind::Cycle : GraphDiagnosticKind::SharedNode, f_Child->m_ID, fp_BlockNode->m_ID });
+                continue;
             }
+
+            fp_Scratch.m_PendingBlockNodes.push_back(f_Child);
         }
 
-        return nullptr;
+        fp_Scratch.m_Stack.push_back({ fp_BlockNode, f_PendingStart, f_PendingStart, fp_Scratch.m_PendingBlockNodes.size() });
     }
 
 
+    //Runs on this thread after the walks, unreachable nodes only show up in broken graphs so there's no point splitting this up
     void 
-        ExecutionParser::FindAndRemoveBlockNode(BlockNode* fp_NodeToBeRemoved)
+        ExecutionParser::ValidateUnreachedBlockNodes()
     {
-        if (!fp_NodeToBeRemoved)
+        vector<BlockNode*> f_WalkPath;
+
+        for (ValidationScratch& l_Scratch : pm_WorkerValidationScratch)
         {
-            //PeachCore::LogManager::Logger().Warn("Invalid input for 'FindAndRemoveBlockNode()", "ExecutionParser");
-            return;
+            for (BlockNode* l_BlockNode : l_Scratch.m_UnreachedBlockNodes)
+            {
+                if (pm_ValidationWalkStates.size() < pm_BlockNodeSlotMap.SlotCount())
+                {
+                    pm_ValidationWalkStates.assign(pm_BlockNodeSlotMap.SlotCount(), 0);
+                }
+
+                BlockNode* f_Parent = FindBlockNode(l_BlockNode->m_ParentID);
+
+                if (l_BlockNode->m_ParentID.IsNull())
+                {
+                    l_Scratch.m_Diagnostics.push_back({ GraphDiagnosticKind::UnplacedNode, l_BlockNode->m_ID });
+                }
+                else if (!f_Parent)
+                {
+                    l_Scratch.m_Diagnostics.push_back({ GraphDiagnosticKind::DanglingParent, l_BlockNode->m_ID, l_BlockNode->m_ParentID });
+                }
+                else if (pm_ValidationVisited.Test(f_Parent->m_ID.m_Index))
+                {
+                    l_Scratch.m_Diagnostics.push_back({ GraphDiagnosticKind::MissingFromParent, l_BlockNode->m_ID, f_Parent->m_ID });
+                }
+
+                //a parent that's unreachable too gets its own diagnostic, the only thing left to find is a m_ParentID loop, each node is walked once
+                f_WalkPath.clear();
+                BlockNode* f_Current = l_BlockNode;
+
+                while (f_Current and pm_ValidationWalkStates[f_Current->m_ID.m_Index] == 0 and not pm_ValidationVisited.Test(f_Current->m_ID.m_Index))
+                {
+                    pm_ValidationWalkStates[f_Current->m_ID.m_Index] = 1;
+                    f_WalkPath.push_back(f_Current);
+                    f_Current = FindBlockNode(f_Current->m_ParentID);
+                }
+
+                if (f_Current and pm_ValidationWalkStates[f_Current->m_ID.m_Index] == 1)
+                {
+                    l_Scratch.m_Diagnostics.push_back({ GraphDiagnosticKind::Cycle, f_Current->m_ID, f_Current->m_ParentID });
+                }
+
+                for (const BlockNode* l_Walked : f_WalkPath)
+                {
+                    pm_ValidationWalkStates[l_Walked->m_ID.m_Index] = 2;
+                }
+            }
+        }
+
+        if (not pm_ValidationWalkStates.empty())
+        {
+            fill(pm_ValidationWalkStates.begin(), pm_ValidationWalkStates.end(), 0); //only dirtied when something was unreachable
         }
+    }
 
-        BlockNode* f_ParentOfNodeToBeRemoved = DFSFindBlockNodeReferenceInTree(fp_NodeToBeRemoved->m_ParentID, false);
 
-        if (!f_ParentOfNodeToBeRemoved) 
+    void 
+        ExecutionParser::AddIfChainDiagnostic(const BlockNode* fp_BlockNode, const BlockNode* fp_PreviousSibling, vector<GraphDiagnostic>& fp_Diagnostics) 
+        const
+    {
+        if (fp_BlockNode->m_Kind != BlockNodeKind::ElseIf and fp_BlockNode->m_Kind != BlockNodeKind::Else)
+        {
+            return;
+        }
+
+        if (fp_PreviousSibling and (fp_PreviousSibling->m_Kind == BlockNodeKind::If or fp_PreviousSibling->m_Kind == BlockNodeKind::ElseIf))
         {
-            //PeachCore::LogManager::Logger().Debug("Parent Node with ID:  could not be found", "ExecutionParser");
             return;
         }
 
-        auto& children = f_ParentOfNodeToBeRemoved->m_Children;
+        fp_Diagnostics.push_back
+        ({
+            fp_BlockNode->m_Kind == BlockNodeKind::Else ? GraphDiagnosticKind::OrphanedElse : GraphDiagnosticKind::OrphanedElseIf,
+            fp_BlockNode->m_ID,
+            fp_PreviousSibling ? fp_PreviousSibling->m_ID : BlockNodeHandle{}
+        });
+    }
+
+
+    //Flags the node and walks up O(depth) until we hit an ancestor that is already dirty, since everything above that one is dirty too.
+    //A walk that makes it all the way up restamps the top level node, which is what outdates the flattened snapshots taken under it
+    void 
+        ExecutionParser::MarkBlockNodeDirty(BlockNode* fp_BlockNode)
+    {
+        if (!fp_BlockNode) { return; }
+
+        fp_BlockNode->m_IsScriptDirty = true;
+        fp_BlockNode->m_IsSubtreeHashDirty = true;
+        fp_BlockNode->m_SnapshotDirtyEpoch = pm_SnapshotEpoch;
+
+        BlockNode* f_TopLevelBlockNode = fp_BlockNode;
 
-        children.erase(remove_if(children.begin(), children.end(),
-            [fp_NodeToBeRemoved](const unique_ptr<BlockNode>& child) {
-                return child.get() == fp_NodeToBeRemoved;
-            }), children.end());
+        for (BlockNode* l_Ancestor = FindBlockNode(fp_BlockNode->m_ParentID); l_Ancestor; l_Ancestor = FindBlockNode(l_Ancestor->m_ParentID))
+        {
+            if (l_Ancestor->m_IsScriptDirty and l_Ancestor->m_IsSubtreeHashDirty and l_Ancestor->m_SnapshotDirtyEpoch == pm_SnapshotEpoch)
+            {
+                f_TopLevelBlockNode = nullptr; //the walk that flagged it already restamped the top level node after its last snapshot
+                break;
+            }
+
+            l_Ancestor->m_IsScriptDirty = true;
+            l_Ancestor->m_IsSubtreeHashDirty = true;
+            l_Ancestor->m_SnapshotDirtyEpoch = pm_SnapshotEpoch;
+            f_TopLevelBlockNode = l_Ancestor;
+        }
+
+        MarkGraphDirty();
 
-        //PeachCore::LogManager::Logger().Debug("Successfully removed BlockNode: " + fp_NodeToBeRemoved->m_Name, "ExecutionParser");
+        if (f_TopLevelBlockNode)
+        {
+            f_TopLevelBlockNode->m_SnapshotRevision = pm_GraphRevision;
+        }
     }
 
 
+    //Used when a branch moves, the cached offsets of everything inside it were relative to a parent that isn't its parent anymore
     void 
-        ExecutionParser::ExecuteScript()
+        ExecutionParser::InvalidateBlockNodeSubtreeScripts(BlockNode* fp_BlockNode)
     {
-        MovePointerReferencesToRootLevelBlockNodeExecutionOrder();
-        SortRootLevelBlockNodeExecutionOrder();
+        pm_Traversal.Walk
+        (
+            fp_BlockNode,
+            [this](BlockNode* fp_Node, const unsigned int)
+            {
+                fp_Node->m_IsScriptDirty = true;
+                fp_Node->m_CachedScript.clear();
+                fp_Node->m_CachedScript.shrink_to_fit(); //only top level nodes keep their text around
+                pm_TopLevelSourceMaps.erase(fp_Node->m_ID.m_Index);
+                pm_FlattenedBlockNodeTrees.erase(fp_Node->m_ID.m_Index); //snapshots inside the branch were stamped against the top level node it hung under before
+            }
+        );
+    }
 
-        // Execute Script
-        RunPythonScript();
 
-        MovePointerReferencesBackToAllCurrentlyPlacedBlockNodes();
+    bool 
+        ExecutionParser::SetBlockNodeName(const BlockNodeHandle fp_BlockNodeID, const string& fp_Name)
+    {
+        BlockNode* f_BlockNode = FindBlockNode(fp_BlockNodeID);
+
+        if (!f_BlockNode) { return false; }
+
+        string f_PreviousName = exchange(f_BlockNode->m_Name, fp_Name);
+        MarkBlockNodeDirty(f_BlockNode);
+
+        if (f_PreviousName != f_BlockNode->m_Name) //retyping the same text isn't worth an undo step
+        {
+            RecordEdit({ EditCommandKind::Name, fp_BlockNodeID, 0, {}, move(f_PreviousName) });
+        }
+
+        return true;
     }
 
 
+    bool 
+        ExecutionParser::SetBlockNodeCodeSnippet(const BlockNodeHandle fp_BlockNodeID, const string& fp_CodeSnippet)
+    {
+        BlockNode* f_BlockNode = FindBlockNode(fp_BlockNodeID);
+
+        if (!f_BlockNode) { return false; }
+
+        string f_PreviousCodeSnippet = exchange(f_BlockNode->m_CodeSnippet, fp_CodeSnippet);
+        MarkBlockNodeDirty(f_BlockNode);
+
+        if (f_PreviousCodeSnippet != f_BlockNode->m_CodeSnippet) //retyping the same text isn't worth an undo step
+        {
+            RecordEdit({ EditCommandKind::CodeSnippet, fp_BlockNodeID, 0, {}, move(f_PreviousCodeSnippet) });
+        }
+
+        return true;
+    }
+
+    //DFS used to build script when ready from root node BlockNodes, strategy is to iterate through all block nodes, run DFS on flagged block nodes
     void 
-        ExecutionParser::MovePointerReferencesToRootLevelBlockNodeExecutionOrder()
+        ExecutionParser::DFS(const BlockNode* fp_Node, unsigned int fp_Depth, ScriptSink& fp_Sink) 
+    {
+        pm_Traversal.Walk(fp_Node, [fp_Depth, &fp_Sink](const BlockNode* fp_Child, const unsigned int fp_ChildDepth) { fp_Child->EmitScript(fp_Sink, fp_Depth + fp_ChildDepth); });
+    }
+
+    //Searches a specific node reference's children all the way down to see if desire BlockNodeID is found, if not found it returns nullptr
+    BlockNode* 
+        ExecutionParser::DFSReturnSpecificBlockNodePointerReference(BlockNode* fp_BlockNode, const BlockNodeHandle fp_BlockNodeID)
+    {
+        return pm_Traversal.Find(fp_BlockNode, [fp_BlockNodeID](const BlockNode* fp_Node) { return fp_Node->m_ID == fp_BlockNodeID; });
+    }
+
+    //Iterates through list of all placed block nodes and applies DFSReturnBlockNodePointerReference() to each root block of the scene and returns nullptr if not found
+    BlockNode* 
+        ExecutionParser::DFSFindBlockNodeReferenceInTree(const BlockNodeHandle fp_BlockNodeID, const bool fp_IsLookingForRoot) 
     {
-        for (int i = pm_AllCurrentlyPlacedBlockNodes.size() - 1; i >= 0; --i) 
+        for (const auto& l_BlockNode : pm_AllCurrentlyPlacedBlockNodes)
         {
-            if (pm_AllCurrentlyPlacedBlockNodes[i]->m_IsRootExecutable) 
+            if (!l_BlockNode->m_IsRootExecutable && fp_IsLookingForRoot) 
+            {
+                continue;
+            }
+
+            BlockNode* result = DFSReturnSpecificBlockNodePointerReference(l_BlockNode, fp_BlockNodeID);
+
+            if (result) 
             {
-                pm_RootLevelBlockNodeExecutionOrder.push_back(move(pm_AllCurrentlyPlacedBlockNodes[i]));
-                pm_AllCurrentlyPlacedBlockNodes.erase(pm_AllCurrentlyPlacedBlockNodes.begin() + i);
+                return result;
             }
         }
+
+        return nullptr;
     }
 
 
     void 
-        ExecutionParser::SortRootLevelBlockNodeExecutionOrder()
+        ExecutionParser::FindAndRemoveBlockNode(const BlockNodeHandle fp_NodeToBeRemoved)
     {
-        sort(
-            pm_RootLevelBlockNodeExecutionOrder.begin(), pm_RootLevelBlockNodeExecutionOrder.end(),
-            [](const unique_ptr<BlockNode>& a, const unique_ptr<BlockNode>& b)
-            {
-                return a->m_InputLineNumber < b->m_InputLineNumber;
-            });
+        BlockNode* f_NodeToBeRemoved = FindBlockNode(fp_NodeToBeRemoved);
+
+        if (!f_NodeToBeRemoved) //stale handles land here too, so callers holding on to removed nodes can't double remove
+        {
+            //PeachCore::LogManager::Logger().Warn("Invalid input for 'FindAndRemoveBlockNode()", "ExecutionParser");
+            return;
+        }
+
+        if (IsRecordingEdits()) //keep the branch around retired so undo can bring it back, it only gets destroyed once the history drops it
+        {
+            EditCommand f_Removal = { EditCommandKind::Liveness, fp_NodeToBeRemoved };
+            ApplyEditCommand(f_Removal);
+            RecordEdit(move(f_Removal));
+            return;
+        }
+
+        DetachBlockNodeFromParent(f_NodeToBeRemoved);
+        DestroyBlockNodeSubtree(f_NodeToBeRemoved); //children are non-owning now, so the removed branch has to be handed back to the arena explicitly
+        MarkGraphDirty();
+
+        //PeachCore::LogManager::Logger().Debug("Successfully removed BlockNode: " + f_NodeToBeRemoved->m_Name, "ExecutionParser");
     }
 
 
     bool 
-        ExecutionParser::CheckIfSorted()
+        ExecutionParser::ReparentBlockNode(const BlockNodeHandle fp_BlockNodeID, const BlockNodeHandle fp_NewParentID)
     {
-        for (int i = 0; i < (pm_AllCurrentlyPlacedBlockNodes.size() - 1) - 1; i++) // -1 again so that we dont go out of bounds for index checking with i + 1
+        BlockNode* f_BlockNode = FindBlockNode(fp_BlockNodeID);
+
+        if (!f_BlockNode) 
+        { 
+            return false; 
+        }
+
+        BlockNode* f_NewParent = nullptr;
+
+        if (not fp_NewParentID.IsNull())
         {
-            if(pm_RootLevelBlockNodeExecutionOrder[i]->m_InputLineNumber > pm_RootLevelBlockNodeExecutionOrder[i + 1]->m_InputLineNumber) //if sorted, index i should be equal to the m_InputLineNumber up to a constant
+            f_NewParent = FindBlockNode(fp_NewParentID);
+
+            if (!f_NewParent) 
+            { 
+                return false; 
+            }
+
+            if (f_NewParent == f_BlockNode)
             {
                 return false;
             }
+
+            for (const BlockNode* l_Ancestor = f_NewParent; l_Ancestor and not f_BlockNode->m_Children.empty(); l_Ancestor = FindBlockNode(l_Ancestor->m_ParentID)) //walk up O(depth) so we never parent a node under its own subtree, a leaf can't have one so freshly created nodes skip it
+            {
+                if (l_Ancestor == f_BlockNode) 
+                { 
+                    return false; 
+                }
+            }
+        }
+
+        const BlockNodePlacement f_PreviousPlacement = IsRecordingEdits() ? CaptureBlockNodePlacement(f_BlockNode) : BlockNodePlacement{};
+
+        DetachBlockNodeFromParent(f_BlockNode);
+
+        if (f_NewParent)
+        {
+            f_NewParent->m_Children.push_back(f_BlockNode);
+            f_NewParent->m_ChildIDs.push_back(f_BlockNode->m_ID);
+            f_BlockNode->m_IsRootExecutable = false; //nested blocks can't stay entry points
+        }
+        else
+        {
+            pm_AllCurrentlyPlacedBlockNodes.push_back(f_BlockNode);
+            pm_AllCurrentlyPlacedBlockNodeIDs.push_back(f_BlockNode->m_ID);
+
+            if (f_BlockNode->m_IsRootExecutable) //moved around the top level, keep its place in the execution order
+            {
+                InsertIntoRootLevelBlockNodeExecutionOrder(f_BlockNode);
+            }
         }
+
+        f_BlockNode->m_ParentID = fp_NewParentID;
+
+        InvalidateBlockNodeSubtreeScripts(f_BlockNode);
+        MarkBlockNodeDirty(f_BlockNode);
+        RecordPlacementEdit(f_BlockNode, f_PreviousPlacement);
+
         return true;
     }
 
 
+    //Unlinks a node from wherever it currently hangs, O(siblings) since the parent comes straight out of the ID index
     void 
-        ExecutionParser::MovePointerReferencesBackToAllCurrentlyPlacedBlockNodes()
+        ExecutionParser::DetachBlockNodeFromParent(BlockNode* fp_BlockNode)
     {
+        BlockNode* f_Parent = FindBlockNode(fp_BlockNode->m_ParentID);
+
+        MarkBlockNodeDirty(f_Parent); //the old parent's text loses this branch
+
+        auto& f_Siblings = f_Parent ? f_Parent->m_Children : pm_AllCurrentlyPlacedBlockNodes;
+        auto& f_SiblingIDs = f_Parent ? f_Parent->m_ChildIDs : pm_AllCurrentlyPlacedBlockNodeIDs;
+
+        const auto f_Sibling = find(f_Siblings.rbegin(), f_Siblings.rend(), fp_BlockNode); //searched from the back, freshly created nodes get reparented right after being pushed onto the top level
+
+        if (f_Sibling != f_Siblings.rend())
+        {
+            f_SiblingIDs.erase(f_SiblingIDs.begin() + (f_Siblings.rend() - f_Sibling - 1));
+            f_Siblings.erase(next(f_Sibling).base());
+        }
+
+        if (fp_BlockNode->m_IsRootExecutable)
+        {
+            EraseFromRootLevelBlockNodeExecutionOrder(fp_BlockNode);
+        }
 
+        fp_BlockNode->m_ParentID = {};
     }
 
 
+    //Returns a node and everything below it to the arena, children first so the parent is still valid while we walk it
     void 
-        ExecutionParser::RunPythonScript()
+        ExecutionParser::DestroyBlockNodeSubtree(BlockNode* fp_BlockNode)
+    {
+        pm_Traversal.Walk
+        (
+            fp_BlockNode,
+            [](const BlockNode*, const unsigned int) {},
+            [this](BlockNode* fp_Node, const unsigned int)
+            {
+                pm_FlattenedBlockNodeTrees.erase(fp_Node->m_ID.m_Index);
+                pm_TopLevelSourceMaps.erase(fp_Node->m_ID.m_Index);
+                pm_BlockNodeSlotMap.Erase(fp_Node->m_ID);
+                pm_BlockNodeArena.Destroy(fp_Node);
+            }
+        );
+    }
+
+
+    //The execution order is maintained as blocks get flagged, so setup here only depends on the flagged roots and not on how many blocks are placed
+    uint64_t 
+        ExecutionParser::ExecuteScript(const chrono::milliseconds fp_Timeout)
     {
+        const GraphValidationReport& f_Report = ValidateGraph();
 
+        if (not f_Report.IsValid()) //a cycle would never finish generating, the rest would just fail inside Python with a less useful error
+        {
+            for (const GraphDiagnostic& l_Diagnostic : f_Report.m_Diagnostics)
+            {
+                PrintError(format("Not executing, block node {} has a structural problem: {}", l_Diagnostic.m_ID.m_Index, GetGraphDiagnosticKindName(l_Diagnostic.m_Kind)));
+            }
+
+            return 0;
+        }
+
+        GenerateRootLevelScript();
+
+        // Execute Script
+        const uint64_t f_RunID = RunPythonScript(fp_Timeout);
+
+        if (f_RunID != 0)
+        {
+            pm_LastRunGraphHash = GetGraphHash();
+        }
+
+        return f_RunID;
+    }
+
+
+    //Rerunning an unchanged graph lands on the same hash, so the interpreter reuses its compiled code object instead of compiling again
+    uint64_t 
+        ExecutionParser::RunPythonScript(const chrono::milliseconds fp_Timeout)
+    {
+        return PythonScriptParser::Parser().SubmitScript(string(pm_CurrentScript.View()), pm_CurrentScriptHash, fp_Timeout); //copied since the graph can be edited (and regenerated) while the script is still running
     }
 }
 
@@ -8,11 +8,498 @@
 
 namespace Princess {
 
-    //namespace py = pybind11;
+    PythonScriptParser::~PythonScriptParser()
+    {
+        ShutdownInterpreter();
+    }
+
+
+    bool 
+        PythonScriptParser::InitializeInterpreter(const string& fp_LogOutputDirectory, const string& fp_BytecodeCacheDirectory)
+    {
+        if (pm_Interpreter)
+        {
+            python_logger->LogAndPrint("Tried to initialize the Python interpreter again! it's already running", "PythonScriptParser", Logger::LogLevel::Warning);
+            return false;
+        }
+
+        python_logger = make_unique<Logger>();
+
+        if (not python_logger->Initialize("script_thread", fp_LogOutputDirectory, "PythonScriptParser"))
+        {
+            PrintError("Unable to initialize Python Logger, exiting execution immediately");
+            return false;
+        }
+
+        try
+        {
+            pm_Interpreter = make_unique<py::scoped_interpreter>();
+        }
+        catch (const exception& fp_Exception)
+        {
+            python_logger->LogAndPrint(format("Failed to start the embedded Python interpreter: {}", fp_Exception.what()), "PythonScriptParser", Logger::LogLevel::Fatal);
+            return false;
+        }
+
+        if (not fp_BytecodeCacheDirectory.empty())
+        {
+            pm_BytecodeCache.Open(fp_BytecodeCacheDirectory, MAX_BYTECODE_CACHE_BYTES, python_logger.get()); //not fatal, scripts just get compiled on every restart without it
+        }
+
+        pm_IsStopping = false;
+        pm_MainThreadGILRelease = make_unique<py::gil_scoped_release>(); //from here on the main thread never runs Python, it only queues work and polls results
+
+        pm_ScriptThread = thread(&PythonScriptParser::ScriptThreadLoop, this);
+        pm_WatchdogThread = thread(&PythonScriptParser::WatchdogThreadLoop, this);
+
+        python_logger->LogAndPrint("Embedded Python interpreter started", "PythonScriptParser", Logger::LogLevel::Debug);
+        return true;
+    }
+
+
+    void 
+        PythonScriptParser::ShutdownInterpreter()
+    {
+        if (not pm_Interpreter) { return; }
+
+        {
+            lock_guard<mutex> f_Lock(pm_ScriptMutex);
+            pm_IsStopping = true;
+            pm_PendingScripts.clear();
+            pm_CancelledRunID = pm_RunningRunID; //whatever is still running gets interrupted so the script thread can be joined
+        }
+
+        pm_ScriptQueued.notify_all();
+        pm_WatchdogWake.notify_all();
+
+        pm_ScriptThread.join(); //the watchdog keeps interrupting until the script thread is out
+        pm_WatchdogThread.join();
+
+        pm_MainThreadGILRelease.reset(); //GIL comes back to the main thread for the teardown
+        pm_CompiledScripts.clear(); //code objects have to go before the interpreter does
+        pm_BytecodeCache.Close();
+        pm_Interpreter.reset();
+
+        while (pm_ScriptEvents.TryPop()) {} //nobody is going to read these anymore
+    }
+
+
+    bool 
+        PythonScriptParser::IsInterpreterRunning() 
+        const
+    {
+        return pm_Interpreter != nullptr;
+    }
+
+
+    void 
+        PythonScriptParser::ClearCompiledScriptCache()
+    {
+        pm_ShouldClearCompiledScripts = true; //the cache belongs to the script thread, it drops it before starting its next run
+    }
+
+
+    uint64_t 
+        PythonScriptParser::SubmitScript(string fp_Script, const uint64_t fp_ScriptHash, const chrono::milliseconds fp_Timeout)
+    {
+        if (not pm_Interpreter)
+        {
+            PrintError("Tried to execute a script before the Python interpreter was initialized");
+            return 0;
+        }
+
+        uint64_t f_RunID;
+
+        {
+            lock_guard<mutex> f_Lock(pm_ScriptMutex);
+            f_RunID = pm_NextRunID++;
+            pm_PendingScripts.push_back({ f_RunID, move(fp_Script), fp_ScriptHash, fp_Timeout });
+        }
+
+        pm_ScriptQueued.notify_one();
+        return f_RunID;
+    }
+
+
+    bool 
+        PythonScriptParser::CancelScript(const uint64_t fp_RunID)
+    {
+        {
+            lock_guard<mutex> f_Lock(pm_ScriptMutex);
+
+            const auto f_Pending = find_if(pm_PendingScripts.begin(), pm_PendingScripts.end(), [fp_RunID](const PendingScript& fp_Pending) { return fp_Pending.m_RunID == fp_RunID; });
+
+            if (f_Pending != pm_PendingScripts.end()) //never started, nothing to interrupt
+            {
+                pm_PendingScripts.erase(f_Pending);
+                return true;
+            }
+
+            if (fp_RunID == 0 or fp_RunID != pm_RunningRunID)
+            {
+                return false;
+            }
+
+            pm_CancelledRunID = fp_RunID;
+        }
+
+        pm_WatchdogWake.notify_one();
+        return true;
+    }
+
+
+    bool 
+        PythonScriptParser::IsScriptRunning() 
+        const
+    {
+        lock_guard<mutex> f_Lock(pm_ScriptMutex);
+        return pm_RunningRunID != 0 or not pm_PendingScripts.empty();
+    }
+
+
+    size_t 
+        PythonScriptParser::PollScriptEvents(const function<void(ScriptEvent&)>& fp_Handler, const size_t fp_MaxEvents)
+    {
+        size_t f_Handled = 0;
+
+        for (; f_Handled < fp_MaxEvents; f_Handled++) //capped so a script spamming print() can't eat a whole frame
+        {
+            optional<ScriptEvent> f_Event = pm_ScriptEvents.TryPop();
+
+            if (not f_Event)
+            {
+                break;
+            }
+
+            fp_Handler(*f_Event);
+        }
+
+        return f_Handled;
+    }
+
+
+    //////////////////////////////////////////////
+    // Script Thread
+    //////////////////////////////////////////////
+
+    void 
+        PythonScriptParser::ScriptThreadLoop()
+    {
+        while (true)
+        {
+            PendingScript f_PendingScript;
+
+            {
+                unique_lock<mutex> f_Lock(pm_ScriptMutex);
+                pm_ScriptQueued.wait(f_Lock, [this] { return pm_IsStopping or not pm_PendingScripts.empty(); });
+
+                if (pm_IsStopping)
+                {
+                    return;
+                }
+
+                f_PendingScript = move(pm_PendingScripts.front());
+                pm_PendingScripts.pop_front();
+            }
+
+            py::gil_scoped_acquire f_GIL; //only held while a script is actually running, the interpreter is free between runs
+
+            {
+                lock_guard<mutex> f_Lock(pm_ScriptMutex);
+
+                if (pm_IsStopping) //shutdown started while we waited on the GIL and the watchdog may already be gone
+                {
+                    return;
+                }
+
+                pm_RunningRunID = f_PendingScript.m_RunID;
+                pm_RunningPythonThreadID = PyThread_get_thread_ident();
+                pm_RunningDeadline = f_PendingScript.m_Timeout > chrono::milliseconds::zero() ? chrono::steady_clock::now() + f_PendingScript.m_Timeout : chrono::steady_clock::time_point::max();
+                pm_InterruptReason = ScriptEvent::Type::Finished;
+            }
+
+            pm_WatchdogWake.notify_one();
+
+            ScriptEvent f_Result = RunScript(f_PendingScript);
+
+            {
+                lock_guard<mutex> f_Lock(pm_ScriptMutex);
+                pm_RunningRunID = 0;
+                PyThreadState_SetAsyncExc(pm_RunningPythonThreadID, nullptr); //the watchdog might have fired right as the script finished, don't let it hit the next run
+            }
+
+            if (pm_DroppedOutputLines > 0)
+            {
+                f_Result.m_Text += format(" ({} lines of output were dropped because the editor wasn't keeping up)", pm_DroppedOutputLines);
+                pm_DroppedOutputLines = 0;
+            }
+
+            PushScriptEvent(move(f_Result));
+        }
+    }
+
+
+    ScriptEvent 
+        PythonScriptParser::RunScript(const PendingScript& fp_PendingScript)
+    {
+        const uint64_t f_RunID = fp_PendingScript.m_RunID;
+
+        py::module_ f_Sys = py::module_::import("sys");
+        py::object f_PreviousStdout = f_Sys.attr("stdout");
+        py::object f_PreviousStderr = f_Sys.attr("stderr");
+
+        struct PendingOutput //partial stdout/stderr line, print() hands us the text and the newline in separate write() calls
+        {
+            uint64_t m_RunID = 0; //the run m_Line was written during
+            string m_Line;
+        };
+
+        const shared_ptr<PendingOutput> f_PendingLines[2] = { make_shared<PendingOutput>(), make_shared<PendingOutput>() };
+
+        //The writers can outlive this call, a script is free to hold on to sys.stdout (logging.basicConfig() does), so they own their
+        //buffer and tag every line with whatever run is going at the time they're written to
+        auto f_MakeWriter = [this](const ScriptEvent::Type fp_Type, const shared_ptr<PendingOutput>& fp_PendingOutput)
+        {
+            return py::module_::import("types").attr("SimpleNamespace")
+            (
+                py::arg("write") = py::cpp_function
+                (
+                    [this, fp_Type, fp_PendingOutput](const string& fp_Text)
+                    {
+                        uint64_t f_RunningRunID;
+
+                        {
+                            lock_guard<mutex> f_Lock(pm_ScriptMutex);
+                            f_RunningRunID = pm_RunningRunID;
+                        }
+
+                        if (f_RunningRunID == 0) //no run to pin it on, eg. a thread some script left running between runs
+                        {
+                            return fp_Text.size();
+                        }
+
+                        if (fp_PendingOutput->m_RunID != f_RunningRunID) //the partial line belongs to a run that's already over
+                        {
+                            fp_PendingOutput->m_RunID = f_RunningRunID;
+                            fp_PendingOutput->m_Line.clear();
+                        }
+
+                        string& f_PendingLine = fp_PendingOutput->m_Line;
+                        f_PendingLine += fp_Text;
+
+                        for (size_t l_Newline = f_PendingLine.find('\n'); l_Newline != string::npos; l_Newline = f_PendingLine.find('\n'))
+                        {
+                            PushScriptEvent({ f_RunningRunID, fp_Type, f_PendingLine.substr(0, l_Newline) });
+                            f_PendingLine.erase(0, l_Newline + 1);
+                        }
+
+                        return fp_Text.size();
+                    }
+                ),
+                py::arg("flush") = py::cpp_function([] {})
+            );
+        };
+
+        ScriptEvent f_Result = { f_RunID, ScriptEvent::Type::Finished, {} };
+
+        try
+        {
+            f_Sys.attr("stdout") = f_MakeWriter(ScriptEvent::Type::Output, f_PendingLines[0]);
+            f_Sys.attr("stderr") = f_MakeWriter(ScriptEvent::Type::ErrorOutput, f_PendingLines[1]);
+
+            const py::object f_CodeObject = GetCompiledScript(fp_PendingScript.m_Script, fp_PendingScript.m_ScriptHash); //own reference, the cache can't pull it out from under the run
+
+            py::dict f_Globals; //fresh module scope per run so one run's variables don't leak into the next
+            f_Globals["__builtins__"] = py::module_::import("builtins");
+            f_Globals["__name__"] = "__main__";
+
+            py::object f_ReturnValue = py::reinterpret_steal<py::object>(PyEval_EvalCode(f_CodeObject.ptr(), f_Globals.ptr(), f_Globals.ptr()));
+
+            if (not f_ReturnValue)
+            {
+                throw py::error_already_set();
+            }
+        }
+        catch (const py::error_already_set& fp_Exception)
+        {
+            ScriptEvent::Type f_InterruptReason;
+
+            {
+                lock_guard<mutex> f_Lock(pm_ScriptMutex);
+                f_InterruptReason = pm_InterruptReason;
+            }
+
+            if (f_InterruptReason != ScriptEvent::Type::Finished and fp_Exception.matches(PyExc_KeyboardInterrupt))
+            {
+                f_Result.m_Type = f_InterruptReason;
+            }
+            else
+            {
+                f_Result.m_Type = ScriptEvent::Type::Failed;
+                f_Result.m_Text = fp_Exception.what();
+            }
+        }
+
+        for (size_t l_Stream = 0; l_Stream < 2; l_Stream++) //whatever didn't end in a newline
+        {
+            PendingOutput& f_PendingOutput = *f_PendingLines[l_Stream];
+
+            if (f_PendingOutput.m_RunID == f_RunID and not f_PendingOutput.m_Line.empty())
+            {
+                PushScriptEvent({ f_RunID, l_Stream == 0 ? ScriptEvent::Type::Output : ScriptEvent::Type::ErrorOutput, move(f_PendingOutput.m_Line) });
+                f_PendingOutput.m_Line.clear();
+            }
+        }
+
+        f_Sys.attr("stdout") = f_PreviousStdout;
+        f_Sys.attr("stderr") = f_PreviousStderr;
+
+        return f_Result;
+    }
+
+
+    py::object 
+        PythonScriptParser::GetCompiledScript(const string_view fp_Script, const uint64_t fp_ScriptHash)
+    {
+        if (pm_ShouldClearCompiledScripts.exchange(false))
+        {
+            pm_CompiledScripts.clear();
+        }
+
+        pm_RunCount++;
+
+        auto f_Compiled = pm_CompiledScripts.find(fp_ScriptHash);
+
+        if (f_Compiled == pm_CompiledScripts.end() or f_Compiled->second.m_ScriptLength != fp_Script.size()) //first run of this script this session
+        {
+            if (pm_CompiledScripts.size() >= MAX_COMPILED_SCRIPTS)
+            {
+                EvictLeastRecentlyRunScript();
+            }
+
+            py::object f_CodeObject = pm_BytecodeCache.Load(fp_Script, fp_ScriptHash); //compiled in an earlier session
+
+            if (not f_CodeObject) //never seen it before, pay for compile() once and keep it for next time
+            {
+                f_CodeObject = CompileScript(fp_Script);
+                pm_BytecodeCache.Store(fp_Script, fp_ScriptHash, f_CodeObject);
+            }
+
+            f_Compiled = pm_CompiledScripts.insert_or_assign(fp_ScriptHash, CompiledPythonScript{ move(f_CodeObject), fp_Script.size() }).first;
+        }
+
+        f_Compiled->second.m_LastUsedRun = pm_RunCount;
+        return f_Compiled->second.m_CodeObject;
+    }
+
+
+    py::object 
+        PythonScriptParser::CompileScript(const string_view fp_Script) 
+        const
+    {
+        return py::module_::import("builtins").attr("compile")(py::str(fp_Script.data(), fp_Script.size()), "<princess>", "exec");
+    }
+
+
+    void 
+        PythonScriptParser::EvictLeastRecentlyRunScript()
+    {
+        auto f_Oldest = pm_CompiledScripts.begin();
+
+        for (auto l_Entry = pm_CompiledScripts.begin(); l_Entry != pm_CompiledScripts.end(); ++l_Entry) //linear is fine, the cache only holds MAX_COMPILED_SCRIPTS entries
+        {
+            if (l_Entry->second.m_LastUsedRun < f_Oldest->second.m_LastUsedRun)
+            {
+                f_Oldest = l_Entry;
+            }
+        }
+
+        if (f_Oldest != pm_CompiledScripts.end())
+        {
+            pm_CompiledScripts.erase(f_Oldest);
+        }
+    }
+
+
+    //Output lines get dropped (and counted) once the queue is nearly full, status events wait for room since the editor needs to see every run end
+    void 
+        PythonScriptParser::PushScriptEvent(ScriptEvent&& fp_Event)
+    {
+        const bool f_IsOutput = fp_Event.m_Type == ScriptEvent::Type::Output or fp_Event.m_Type == ScriptEvent::Type::ErrorOutput;
+
+        if (f_IsOutput)
+        {
+            if (pm_ScriptEvents.ApproximateSize() >= SCRIPT_EVENT_CAPACITY - RESERVED_STATUS_EVENTS or not pm_ScriptEvents.TryPush(move(fp_Event)))
+            {
+                pm_DroppedOutputLines++;
+            }
+
+            return;
+        }
+
+        while (not pm_ScriptEvents.TryPush(move(fp_Event)) and not pm_IsStopping)
+        {
+            this_thread::yield();
+        }
+    }
+
+
+    //////////////////////////////////////////////
+    // Watchdog Thread
+    //////////////////////////////////////////////
+
+    void 
+        PythonScriptParser::WatchdogThreadLoop()
+    {
+        static constexpr chrono::milliseconds INTERRUPT_RETRY_INTERVAL = chrono::milliseconds(100); //for scripts that catch the first KeyboardInterrupt
+
+        unique_lock<mutex> f_Lock(pm_ScriptMutex);
+
+        while (true)
+        {
+            if (pm_RunningRunID == 0)
+            {
+                if (pm_IsStopping)
+                {
+                    return; //the script thread exits on its own once it sees pm_IsStopping between runs
+                }
+
+                pm_WatchdogWake.wait(f_Lock);
+                continue;
+            }
+
+            const bool f_IsCancelled = pm_CancelledRunID == pm_RunningRunID;
+            const bool f_IsTimedOut = chrono::steady_clock::now() >= pm_RunningDeadline;
+
+            if (not f_IsCancelled and not f_IsTimedOut)
+            {
+                pm_WatchdogWake.wait_until(f_Lock, pm_RunningDeadline);
+                continue;
+            }
+
+            const uint64_t f_RunID = pm_RunningRunID;
+            pm_InterruptReason = f_IsCancelled ? ScriptEvent::Type::Cancelled : ScriptEvent::Type::TimedOut;
+
+            f_Lock.unlock(); //GIL first, then the mutex, same order the script thread uses
+
+            {
+                py::gil_scoped_acquire f_GIL;
+                lock_guard<mutex> f_RunLock(pm_ScriptMutex);
+
+                if (pm_RunningRunID == f_RunID) //could have finished while we waited on the GIL
+                {
+                    PyThreadState_SetAsyncExc(pm_RunningPythonThreadID, PyExc_KeyboardInterrupt);
+                }
+            }
+
+            f_Lock.lock();
+            pm_WatchdogWake.wait_for(f_Lock, INTERRUPT_RETRY_INTERVAL, [this, f_RunID] { return pm_RunningRunID != f_RunID; });
+        }
+    }
 
     //void PythonScriptParser::ExtractFunctionInformationFromPythonModule(const std::string& fp_DesiredModuleImport) 
     //{
-    //    py::scoped_interpreter guard{}; // Start the Python interpreter
+    //    if (not pm_Interpreter) { return; } //runs on the interpreter EditorManager keeps alive, no more spinning one up per call
 
     //    auto sys = py::module_::import("sys");
     //    sys.attr("path").attr("append")("D:/Game Development/Random Junk I Like to Keep/"); // Add your script directory to sys.path
@@ -0,0 +1,425 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#include "../../include/Parsers/ScriptBytecodeCache.h"
+#include "../../include/Parsers/ScriptHash.h"
+
+#include <marshal.h>
+
+#include <charconv>
+#include <chrono>
+#include <cstring>
+
+namespace Princess {
+
+    namespace {
+
+        uint64_t
+            GetCurrentUnixMicroseconds()
+        {
+            return static_cast<uint64_t>(chrono::duration_cast<chrono::microseconds>(chrono::system_clock::now().time_since_epoch()).count());
+        }
+
+        bool
+            ReadWholeFile(const string& fp_Path, string& fp_Contents)
+        {
+            PHYSFS_File* f_File = PHYSFS_openRead(fp_Path.c_str());
+
+            if (not f_File)
+            {
+                return false;
+            }
+
+            const PHYSFS_sint64 f_Length = PHYSFS_fileLength(f_File);
+            bool f_Success = f_Length >= 0;
+
+            if (f_Success)
+            {
+                fp_Contents.resize(static_cast<size_t>(f_Length));
+                f_Success = PHYSFS_readBytes(f_File, fp_Contents.data(), fp_Contents.size()) == f_Length;
+            }
+
+            PHYSFS_close(f_File);
+            return f_Success;
+        }
+    }
+
+
+    bool
+        ScriptBytecodeCache::Open(const string& fp_CacheDirectory, const uint64_t fp_MaxCacheBytes, Logger* fp_Logger)
+    {
+        Close();
+
+        pm_Logger = fp_Logger;
+
+        const char* f_WriteDirectory = PHYSFS_isInit() ? PHYSFS_getWriteDir() : nullptr;
+
+        if (not f_WriteDirectory)
+        {
+            LogWarning("PhysFS has no write directory, scripts will be compiled on every restart");
+            return false;
+        }
+
+        //entries are read back through the search path, make sure the write dir is on it (no-op if it's mounted already, like EditorManager does)
+        if (not PHYSFS_mount(f_WriteDirectory, nullptr, 0) or not PHYSFS_mkdir(fp_CacheDirectory.c_str()))
+        {
+            LogWarning(format("Unable to set up the bytecode cache in {}/{}: {}", f_WriteDirectory, fp_CacheDirectory, PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode())));
+            return false;
+        }
+
+        pm_CacheDirectory = fp_CacheDirectory;
+        pm_MaxCacheBytes = fp_MaxCacheBytes;
+
+        try
+        {
+            const py::object f_CacheTag = py::module_::import("sys").attr("implementation").attr("cache_tag"); //eg. cpython-313, None if the interpreter doesn't do bytecode caching
+            const string f_MagicNumber = py::module_::import("importlib.util").attr("MAGIC_NUMBER").cast<string>(); //bumped whenever the bytecode format changes
+
+            pm_InterpreterTag = HashScript(f_MagicNumber, HashScript(f_CacheTag.is_none() ? "" : f_CacheTag.cast<string>()));
+        }
+        catch (const exception& fp_Exception)
+        {
+            LogWarning(format("Unable to read the interpreter version for the bytecode cache: {}", fp_Exception.what()));
+            return false;
+        }
+
+        char** f_FileNames = PHYSFS_enumerateFiles(pm_CacheDirectory.c_str());
+
+        for (char** l_FileName = f_FileNames; f_FileNames and *l_FileName; l_FileName++)
+        {
+            const string_view f_FileName = *l_FileName;
+            uint64_t f_EntryKey = 0;
+
+            if (not f_FileName.ends_with(ENTRY_EXTENSION))
+            {
+                continue;
+            }
+
+            const string_view f_Stem = f_FileName.substr(0, f_FileName.size() - ENTRY_EXTENSION.size());
+
+            if (from_chars(f_Stem.data(), f_Stem.data() + f_Stem.size(), f_EntryKey, 16).ptr != f_Stem.data() + f_Stem.size())
+            {
+                continue;
+            }
+
+            PHYSFS_Stat f_Stat;
+
+            if (PHYSFS_stat(GetEntryPath(f_EntryKey).c_str(), &f_Stat) and f_Stat.filetype == PHYSFS_FILETYPE_REGULAR)
+            {
+                const uint64_t f_FileBytes = static_cast<uint64_t>(max<PHYSFS_sint64>(f_Stat.filesize, 0));
+                const uint64_t f_ModifiedTime = static_cast<uint64_t>(max<PHYSFS_sint64>(f_Stat.modtime, 0)) * 1'000'000; //until the index says otherwise
+
+                pm_Entries[f_EntryKey] = { f_FileBytes, f_ModifiedTime };
+                pm_CacheBytes += f_FileBytes;
+            }
+        }
+
+        PHYSFS_freeList(f_FileNames);
+
+        LoadIndex();
+
+        pm_IsOpen = true;
+        EvictUntilUnderBudget(); //the budget might have shrunk since last time
+
+        return true;
+    }
+
+
+    void
+        ScriptBytecodeCache::Close()
+    {
+        if (pm_IsOpen)
+        {
+            SaveIndex();
+        }
+
+        pm_IsOpen = false;
+        pm_Entries.clear();
+        pm_CacheBytes = 0;
+    }
+
+
+    bool
+        ScriptBytecodeCache::IsOpen()
+        const
+    {
+        return pm_IsOpen;
+    }
+
+
+    py::object
+        ScriptBytecodeCache::Load(const string_view fp_Script, const uint64_t fp_ScriptHash)
+    {
+        if (not pm_IsOpen) { return {}; }
+
+        const uint64_t f_EntryKey = GetEntryKey(fp_ScriptHash);
+        const auto f_Entry = pm_Entries.find(f_EntryKey);
+
+        if (f_Entry == pm_Entries.end())
+        {
+            return {};
+        }
+
+        string f_Contents;
+        EntryHeader f_Header;
+
+        if (not ReadWholeFile(GetEntryPath(f_EntryKey), f_Contents) or f_Contents.size() < sizeof(EntryHeader))
+        {
+            RemoveEntry(f_EntryKey);
+            return {};
+        }
+
+        memcpy(&f_Header, f_Contents.data(), sizeof(EntryHeader));
+
+        const EntryHeader f_Expected = { .m_InterpreterTag = pm_InterpreterTag, .m_ScriptHash = fp_ScriptHash, .m_ScriptLength = fp_Script.size() };
+
+        if (memcmp(f_Header.m_Magic, f_Expected.m_Magic, sizeof(f_Header.m_Magic)) != 0 or f_Header.m_FormatVersion != f_Expected.m_FormatVersion
+            or f_Header.m_InterpreterTag != f_Expected.m_InterpreterTag or f_Header.m_ScriptHash != f_Expected.m_ScriptHash or f_Header.m_ScriptLength != f_Expected.m_ScriptLength)
+        {
+            RemoveEntry(f_EntryKey); //stale or colliding, either way it's never going to be right for this key
+            return {};
+        }
+
+        py::object f_CodeObject = py::reinterpret_steal<py::object>(PyMarshal_ReadObjectFromString(f_Contents.data() + sizeof(EntryHeader), static_cast<Py_ssize_t>(f_Contents.size() - sizeof(EntryHeader))));
+
+        if (not f_CodeObject or not PyCode_Check(f_CodeObject.ptr())) //truncated write from a crash, or someone poking at the directory
+        {
+            PyErr_Clear();
+            RemoveEntry(f_EntryKey);
+            return {};
+        }
+
+        f_Entry->second.m_LastUsed = GetCurrentUnixMicroseconds();
+        return f_CodeObject;
+    }
+
+
+    void
+        ScriptBytecodeCache::Store(const string_view fp_Script, const uint64_t fp_ScriptHash, const py::object& fp_CodeObject)
+    {
+        if (not pm_IsOpen) { return; }
+
+        const py::object f_Marshalled = py::reinterpret_steal<py::object>(PyMarshal_WriteObjectToString(fp_CodeObject.ptr(), Py_MARSHAL_VERSION));
+
+        if (not f_Marshalled)
+        {
+            PyErr_Clear();
+            LogWarning("Unable to marshal a compiled script for the bytecode cache");
+            return;
+        }
+
+        char* f_Payload = nullptr;
+        Py_ssize_t f_PayloadLength = 0;
+        PyBytes_AsStringAndSize(f_Marshalled.ptr(), &f_Payload, &f_PayloadLength);
+
+        const uint64_t f_FileBytes = sizeof(EntryHeader) + static_cast<uint64_t>(f_PayloadLength);
+
+        if (f_FileBytes > pm_MaxCacheBytes) //would just evict everything else and then itself
+        {
+            return;
+        }
+
+        const uint64_t f_EntryKey = GetEntryKey(fp_ScriptHash);
+        const EntryHeader f_Header = { .m_InterpreterTag = pm_InterpreterTag, .m_ScriptHash = fp_ScriptHash, .m_ScriptLength = fp_Script.size() }; //native byte order, the cache never leaves this machine
+
+        RemoveEntry(f_EntryKey);
+
+        PHYSFS_File* f_File = PHYSFS_openWrite(GetEntryPath(f_EntryKey).c_str());
+
+        if (not f_File)
+        {
+            LogWarning(format("Unable to write to the bytecode cache: {}", PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode())));
+            return;
+        }
+
+        const bool f_Success = PHYSFS_writeBytes(f_File, &f_Header, sizeof(EntryHeader)) == static_cast<PHYSFS_sint64>(sizeof(EntryHeader))
+            and PHYSFS_writeBytes(f_File, f_Payload, static_cast<PHYSFS_uint64>(f_PayloadLength)) == f_PayloadLength;
+
+        PHYSFS_close(f_File);
+
+        if (not f_Success)
+        {
+            PHYSFS_delete(GetEntryPath(f_EntryKey).c_str()); //disk full most likely, a partial file would only fail to load later anyway
+            return;
+        }
+
+        pm_Entries[f_EntryKey] = { f_FileBytes, GetCurrentUnixMicroseconds() };
+        pm_CacheBytes += f_FileBytes;
+
+        EvictUntilUnderBudget();
+    }
+
+
+    void
+        ScriptBytecodeCache::Clear()
+    {
+        while (not pm_Entries.empty())
+        {
+            RemoveEntry(pm_Entries.begin()->first);
+        }
+
+        if (pm_IsOpen)
+        {
+            PHYSFS_delete((pm_CacheDirectory + "/" + string(INDEX_FILE_NAME)).c_str());
+        }
+    }
+
+
+    uint64_t
+        ScriptBytecodeCache::GetCacheBytes()
+        const
+    {
+        return pm_CacheBytes;
+    }
+
+
+    size_t
+        ScriptBytecodeCache::GetEntryCount()
+        const
+    {
+        return pm_Entries.size();
+    }
+
+
+    //////////////////////////////////////////////
+    // Private Helpers
+    //////////////////////////////////////////////
+
+    uint64_t
+        ScriptBytecodeCache::GetEntryKey(const uint64_t fp_ScriptHash)
+        const
+    {
+        return HashScript(string_view(reinterpret_cast<const char*>(&fp_ScriptHash), sizeof(fp_ScriptHash)), pm_InterpreterTag);
+    }
+
+
+    string
+        ScriptBytecodeCache::GetEntryPath(const uint64_t fp_EntryKey)
+        const
+    {
+        return format("{}/{:016x}{}", pm_CacheDirectory, fp_EntryKey, ENTRY_EXTENSION);
+    }
+
+
+    //one "<key in hex> <last used>" per line, entries that aren't in it keep their modification time
+    void
+        ScriptBytecodeCache::LoadIndex()
+    {
+        string f_Contents;
+
+        if (not ReadWholeFile(pm_CacheDirectory + "/" + string(INDEX_FILE_NAME), f_Contents))
+        {
+            return;
+        }
+
+        string_view f_Remaining = f_Contents;
+
+        while (not f_Remaining.empty())
+        {
+            const size_t f_LineEnd = min(f_Remaining.find('\n'), f_Remaining.size());
+            const string_view f_Line = f_Remaining.substr(0, f_LineEnd);
+            f_Remaining.remove_prefix(min(f_LineEnd + 1, f_Remaining.size()));
+
+            uint64_t f_EntryKey = 0;
+            uint64_t f_LastUsed = 0;
+
+            const auto [f_KeyEnd, f_KeyError] = from_chars(f_Line.data(), f_Line.data() + f_Line.size(), f_EntryKey, 16);
+
+            if (f_KeyError != errc() or f_KeyEnd == f_Line.data() + f_Line.size()
+                or from_chars(f_KeyEnd + 1, f_Line.data() + f_Line.size(), f_LastUsed).ec != errc())
+            {
+                continue;
+            }
+
+            const auto f_Entry = pm_Entries.find(f_EntryKey);
+
+            if (f_Entry != pm_Entries.end())
+            {
+                f_Entry->second.m_LastUsed = f_LastUsed;
+            }
+        }
+    }
+
+
+    void
+        ScriptBytecodeCache::SaveIndex()
+        const
+    {
+        string f_Contents;
+        f_Contents.reserve(pm_Entries.size() * 40);
+
+        for (const auto& [l_EntryKey, l_Entry] : pm_Entries)
+        {
+            f_Contents += format("{:016x} {}\n", l_EntryKey, l_Entry.m_LastUsed);
+        }
+
+        PHYSFS_File* f_File = PHYSFS_openWrite((pm_CacheDirectory + "/" + string(INDEX_FILE_NAME)).c_str());
+
+        if (not f_File)
+        {
+            LogWarning(format("Unable to save the bytecode cache index: {}", PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode())));
+            return;
+        }
+
+        PHYSFS_writeBytes(f_File, f_Contents.data(), f_Contents.size());
+        PHYSFS_close(f_File);
+    }
+
+
+    void
+        ScriptBytecodeCache::RemoveEntry(const uint64_t fp_EntryKey)
+    {
+        const auto f_Entry = pm_Entries.find(fp_EntryKey);
+
+        if (f_Entry == pm_Entries.end())
+        {
+            return;
+        }
+
+        PHYSFS_delete(GetEntryPath(fp_EntryKey).c_str());
+        pm_CacheBytes -= f_Entry->second.m_FileBytes;
+        pm_Entries.erase(f_Entry);
+    }
+
+
+    void
+        ScriptBytecodeCache::EvictUntilUnderBudget()
+    {
+        while (pm_CacheBytes > pm_MaxCacheBytes and not pm_Entries.empty())
+        {
+            auto f_Oldest = pm_Entries.begin();
+
+            for (auto l_Entry = pm_Entries.begin(); l_Entry != pm_Entries.end(); ++l_Entry) //usually one eviction per store, not worth keeping a second ordered structure in sync
+            {
+                if (l_Entry->second.m_LastUsed < f_Oldest->second.m_LastUsed)
+                {
+                    f_Oldest = l_Entry;
+                }
+            }
+
+            RemoveEntry(f_Oldest->first);
+        }
+    }
+
+
+    void
+        ScriptBytecodeCache::LogWarning(const string& fp_Message)
+        const
+    {
+        if (pm_Logger)
+        {
+            pm_Logger->LogAndPrint(fp_Message, "ScriptBytecodeCache", Logger::LogLevel::Warning);
+        }
+        else
+        {
+            PrintError(fp_Message);
+        }
+    }
+}
@@ -0,0 +1,690 @@
+/*******************************************************************
+ *                                             Princess v0.0.1
+ *                           Created by Ranyodh Mandur - � 2024
+ *
+ *                         Licensed under the MIT License (MIT).
+ *                  For more details, see the LICENSE file or visit:
+ *                        https://opensource.org/licenses/MIT
+ *
+ *                         Princess is an open-source visual code editor
+********************************************************************/
+#include "../../include/Parsers/ScriptOptimizer.h"
+
+namespace Princess {
+
+    namespace {
+
+        std::string_view
+            TrimWhitespace(std::string_view fp_Text)
+        {
+            const size_t f_First = fp_Text.find_first_not_of(" \t\r\n");
+
+            if (f_First == std::string_view::npos)
+            {
+                return {};
+            }
+
+            return fp_Text.substr(f_First, fp_Text.find_last_not_of(" \t\r\n") - f_First + 1);
+        }
+
+        bool
+            IsDigit(const char fp_Character)
+        {
+            return fp_Character >= '0' and fp_Character <= '9';
+        }
+
+        bool
+            IsIdentifier(const std::string_view fp_Text) //plain names only, attribute and subscript targets can run setters so they never get merged
+        {
+            if (fp_Text.empty() or IsDigit(fp_Text.front()))
+            {
+                return false;
+            }
+
+            for (const char l_Character : fp_Text)
+            {
+                if (not (IsDigit(l_Character) or l_Character == '_' or (l_Character >= 'a' and l_Character <= 'z') or (l_Character >= 'A' and l_Character <= 'Z')))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        bool
+            IsBlockOpener(const BlockNodeKind fp_Kind) //kinds Python needs at least one indented statement under
+        {
+            switch (fp_Kind)
+            {
+            case BlockNodeKind::FunctionDefinition: case BlockNodeKind::Function:
+            case BlockNodeKind::WhileLoop: case BlockNodeKind::ForLoop: case BlockNodeKind::ForEach:
+            case BlockNodeKind::If: case BlockNodeKind::ElseIf: case BlockNodeKind::Else:
+                return true;
+
+            default:
+                return false;
+            }
+        }
+
+        //single line string literal without a prefix, implicit concatenation and triple quotes are left alone
+        bool
+            IsStringLiteral(const std::string_view fp_Text)
+        {
+            if (fp_Text.size() < 2 or (fp_Text.front() != '\'' and fp_Text.front() != '"') or fp_Text.back() != fp_Text.front())
+            {
+                return false;
+            }
+
+            const char f_Quote = fp_Text.front();
+
+            for (size_t l_Index = 1; l_Index + 1 < fp_Text.size(); l_Index++)
+            {
+                const char f_Character = fp_Text[l_Index];
+
+                if (f_Character == '\n' or f_Character == f_Quote)
+                {
+                    return false;
+                }
+
+                if (f_Character == '\\')
+                {
+                    if (l_Index + 2 >= fp_Text.size()) //escapes the closing quote
+                    {
+                        return false;
+                    }
+
+                    l_Index++;
+                }
+            }
+
+            return true;
+        }
+
+        //Python's digitpart, digit (["_"] digit)*, so underscores only ever sit alone between two digits. Returns how many characters it
+        //covers, 0 if fp_Text doesn't start with one. Prefixed integers may also put one right after the prefix ("0x_ff")
+        template<typename IS_DIGIT>
+        size_t
+            ScanDigitPart(const std::string_view fp_Text, IS_DIGIT&& fp_IsDigit, bool& fp_IsZero, const bool fp_AllowsLeadingUnderscore = false)
+        {
+            size_t f_Length = 0;
+
+            while (f_Length < fp_Text.size())
+            {
+                const bool f_HasUnderscore = fp_Text[f_Length] == '_' and (f_Length > 0 or fp_AllowsLeadingUnderscore);
+                const size_t f_DigitIndex = f_Length + (f_HasUnderscore ? 1 : 0);
+
+                if (f_DigitIndex >= fp_Text.size() or not fp_IsDigit(fp_Text[f_DigitIndex]))
+                {
+                    break; //a trailing or doubled '_' is left over, and the caller rejects the literal for it
+                }
+
+                fp_IsZero = fp_IsZero and fp_Text[f_DigitIndex] == '0';
+                f_Length = f_DigitIndex + 1;
+            }
+
+            return f_Length;
+        }
+
+        bool
+            ParseNumberLiteral(std::string_view fp_Text, bool& fp_IsZero) //false for anything Python wouldn't accept as a number, so folding never makes a broken script run
+        {
+            if (not fp_Text.empty() and (fp_Text.front() == '+' or fp_Text.front() == '-')) //unary sign never changes whether it's zero
+            {
+                fp_Text.remove_prefix(1);
+            }
+
+            fp_IsZero = true;
+
+            if (fp_Text.size() > 2 and fp_Text[0] == '0' and std::string_view("xXoObB").find(fp_Text[1]) != std::string_view::npos)
+            {
+                const char f_Base = static_cast<char>(fp_Text[1] | 0x20);
+
+                auto f_IsBaseDigit = [f_Base](const char fp_Character)
+                {
+                    const char f_Lower = static_cast<char>(fp_Character | 0x20);
+                    return f_Base == 'x' ? IsDigit(fp_Character) or (f_Lower >= 'a' and f_Lower <= 'f') : f_Base == 'o' ? fp_Character >= '0' and fp_Character <= '7' : fp_Character == '0' or fp_Character == '1';
+                };
+
+                const size_t f_DigitsLength = ScanDigitPart(fp_Text.substr(2), f_IsBaseDigit, fp_IsZero, true);
+                return f_DigitsLength > 0 and f_DigitsLength == fp_Text.size() - 2;
+            }
+
+            const bool f_IsImaginary = not fp_Text.empty() and (fp_Text.back() == 'j' or fp_Text.back() == 'J'); //0j is still falsy
+
+            if (f_IsImaginary)
+            {
+                fp_Text.remove_suffix(1);
+            }
+
+            auto f_IsDecimalDigit = [](const char fp_Character) { return IsDigit(fp_Character); };
+
+            const size_t f_IntegerLength = ScanDigitPart(fp_Text, f_IsDecimalDigit, fp_IsZero);
+            size_t f_Position = f_IntegerLength;
+            size_t f_FractionLength = 0;
+            bool f_IsFloat = false;
+
+            if (f_Position < fp_Text.size() and fp_Text[f_Position] == '.')
+            {
+                f_FractionLength = ScanDigitPart(fp_Text.substr(f_Position + 1), f_IsDecimalDigit, fp_IsZero);
+                f_Position += 1 + f_FractionLength;
+                f_IsFloat = true;
+            }
+
+            if (f_IntegerLength == 0 and f_FractionLength == 0) //"." or "e5" or an empty string
+            {
+                return false;
+            }
+
+            if (f_Position < fp_Text.size() and (fp_Text[f_Position] == 'e' or fp_Text[f_Position] == 'E'))
+            {
+                f_Position++;
+
+                if (f_Position < fp_Text.size() and (fp_Text[f_Position] == '+' or fp_Text[f_Position] == '-'))
+                {
+                    f_Position++;
+                }
+
+                bool f_IsExponentZero = true; //the exponent doesn't decide whether the number is zero
+                const size_t f_ExponentLength = ScanDigitPart(fp_Text.substr(f_Position), f_IsDecimalDigit, f_IsExponentZero);
+
+                if (f_ExponentLength == 0)
+                {
+                    return false;
+                }
+
+                f_Position += f_ExponentLength;
+                f_IsFloat = true;
+            }
+
+            if (f_Position != fp_Text.size())
+            {
+                return false;
+            }
+
+            if (not f_IsFloat and not f_IsImaginary and fp_Text.front() == '0' and not fp_IsZero) //"017" is a SyntaxError, only a run of zeros may start with 0, "017j" and "017.0" are fine
+            {
+                return false;
+            }
+
+            return true;
+        }
+
+        bool
+            StripEnclosingParentheses(std::string_view& fp_Text)
+        {
+            if (fp_Text.size() < 2 or fp_Text.front() != '(' or fp_Text.back() != ')')
+            {
+                return false;
+            }
+
+            int f_Depth = 0;
+
+            for (size_t l_Index = 0; l_Index < fp_Text.size(); l_Index++)
+            {
+                f_Depth += fp_Text[l_Index] == '(' ? 1 : fp_Text[l_Index] == ')' ? -1 : 0;
+
+                if (f_Depth == 0 and l_Index + 1 < fp_Text.size()) //"(a) or (b)", the first paren closes early
+                {
+                    return false;
+                }
+            }
+
+            fp_Text = TrimWhitespace(fp_Text.substr(1, fp_Text.size() - 2));
+            return not fp_Text.empty();
+        }
+    }
+
+    //////////////////////////////////////////////
+    // Literal Evaluation
+    //////////////////////////////////////////////
+
+    ScriptOptimizer::ConstantCondition
+        ScriptOptimizer::EvaluateConstantCondition(const std::string_view fp_Condition)
+    {
+        std::string_view f_Text = TrimWhitespace(fp_Condition);
+        bool f_IsNegated = false;
+
+        while (true)
+        {
+            if (StripEnclosingParentheses(f_Text))
+            {
+                continue;
+            }
+
+            if (f_Text.size() > 3 and f_Text.starts_with("not") and (f_Text[3] == ' ' or f_Text[3] == '\t' or f_Text[3] == '('))
+            {
+                f_IsNegated = not f_IsNegated;
+                f_Text = TrimWhitespace(f_Text.substr(3));
+                continue;
+            }
+
+            break;
+        }
+
+        bool f_IsTruthy = false;
+        bool f_IsZero = false;
+
+        if (f_Text == "True") { f_IsTruthy = true; }
+        else if (f_Text == "False" or f_Text == "None") { f_IsTruthy = false; }
+        else if (IsStringLiteral(f_Text)) { f_IsTruthy = f_Text.size() > 2; }
+        else if (ParseNumberLiteral(f_Text, f_IsZero)) { f_IsTruthy = not f_IsZero; }
+        else { return ConstantCondition::Unknown; }
+
+        return f_IsTruthy != f_IsNegated ? ConstantCondition::True : ConstantCondition::False;
+    }
+
+
+    bool
+        ScriptOptimizer::IsLiteralExpression(const std::string_view fp_Expression)
+    {
+        const std::string_view f_Text = TrimWhitespace(fp_Expression);
+        bool f_IsZero = false;
+
+        return f_Text == "True" or f_Text == "False" or f_Text == "None" or IsStringLiteral(f_Text) or ParseNumberLiteral(f_Text, f_IsZero);
+    }
+
+    //////////////////////////////////////////////
+    // Optimization
+    //////////////////////////////////////////////
+
+    const FlattenedBlockNodeTree&
+        ScriptOptimizer::Optimize(const FlattenedBlockNodeTree& fp_Snapshot, const ScriptOptimizationPasses fp_Passes)
+    {
+        pm_Passes = fp_Passes;
+        pm_Input = &fp_Snapshot;
+        pm_RemovedNodeCount = 0;
+        pm_PassOffset = pm_TrueOffset = pm_FalseOffset = UINT32_MAX;
+
+        pm_Output.m_RootID = fp_Snapshot.m_RootID;
+        pm_Output.m_BuiltAtRevision = fp_Snapshot.m_BuiltAtRevision;
+        pm_Output.m_StringPool.assign(fp_Snapshot.m_StringPool); //untouched entries keep their offsets, rewritten text gets appended
+        pm_Output.m_Nodes.clear();
+        pm_OpenLevels.clear();
+
+        const std::vector<FlattenedBlockNode>& f_Nodes = fp_Snapshot.m_Nodes;
+
+        if (f_Nodes.empty() or fp_Passes == ScriptOptimizationPasses::None)
+        {
+            pm_Output.m_Nodes.assign(f_Nodes.begin(), f_Nodes.end());
+            return pm_Output;
+        }
+
+        const bool f_IsEliminatingDeadBranches = HasPass(ScriptOptimizationPasses::EliminateDeadBranches);
+        const bool f_IsEvaluatingConditions = f_IsEliminatingDeadBranches or HasPass(ScriptOptimizationPasses::FoldConstantConditions);
+
+        pm_Output.m_Nodes.push_back(f_Nodes.front()); //the root anchors the snapshot (and its cache), it's always written as is
+        pm_OpenLevels.push_back({ f_Nodes.front().m_Depth, 0, f_Nodes.front().m_Depth + 1, 0, f_Nodes.front().m_SubtreeSize > 1 });
+
+        uint32_t l_Index = 1;
+
+        while (l_Index < f_Nodes.size())
+        {
+            const FlattenedBlockNode& f_Entry = f_Nodes[l_Index];
+
+            while (pm_OpenLevels.back().m_InputDepth >= f_Entry.m_Depth) //the root level is never closed here, everything else is deeper than it
+            {
+                CloseLevel();
+            }
+
+            OpenLevel& f_Parent = pm_OpenLevels.back();
+
+            if (f_IsEliminatingDeadBranches and f_Parent.m_IsUnreachable)
+            {
+                DropSubtree(l_Index);
+                l_Index += f_Entry.m_SubtreeSize;
+                continue;
+            }
+
+            const BlockNodeKind f_Kind = f_Entry.m_Kind;
+            const bool f_IsChainMember = f_Kind == BlockNodeKind::ElseIf or f_Kind == BlockNodeKind::Else;
+            const bool f_HasCondition = f_Kind == BlockNodeKind::If or f_Kind == BlockNodeKind::ElseIf or f_Kind == BlockNodeKind::WhileLoop;
+            const ConstantCondition f_Condition = f_HasCondition and f_IsEvaluatingConditions ? EvaluateConstantCondition(pm_Input->GetCodeSnippet(f_Entry)) : ConstantCondition::Unknown;
+
+            if (not f_IsChainMember)
+            {
+                f_Parent.m_Chain = ChainState::None;
+            }
+
+            if (f_Kind == BlockNodeKind::VariableDefinition and HasPass(ScriptOptimizationPasses::MergeVariableDefinitions))
+            {
+                const uint32_t f_MergedCount = MergeVariableDefinitions(l_Index);
+
+                if (f_MergedCount > 0)
+                {
+                    l_Index += f_MergedCount;
+                    continue;
+                }
+            }
+
+            if (not f_IsEliminatingDeadBranches)
+            {
+                WriteEntry(f_Entry, f_Kind, f_Condition);
+                l_Index++;
+                continue;
+            }
+
+            //every branch below either writes the entry, hoists its children or skips its whole subtree, f_Parent is only touched before that
+            switch (f_Kind)
+            {
+            case BlockNodeKind::If:
+                if (f_Condition == ConstantCondition::False)
+                {
+                    f_Parent.m_Chain = ChainState::AllFalse;
+                    DropSubtree(l_Index);
+                    l_Index += f_Entry.m_SubtreeSize;
+                    continue;
+                }
+
+                f_Parent.m_Chain = f_Condition == ConstantCondition::True ? ChainState::Taken : ChainState::Open;
+                f_Condition == ConstantCondition::True ? HoistEntry(f_Entry) : WriteEntry(f_Entry, f_Kind, f_Condition);
+                break;
+
+            case BlockNodeKind::ElseIf:
+                if (f_Parent.m_Chain == ChainState::Taken or f_Condition == ConstantCondition::False)
+                {
+                    DropSubtree(l_Index);
+                    l_Index += f_Entry.m_SubtreeSize;
+                    continue;
+                }
+
+                if (f_Parent.m_Chain == ChainState::AllFalse) //nothing before it survived, so it starts the chain now
+                {
+                    f_Parent.m_Chain = f_Condition == ConstantCondition::True ? ChainState::Taken : ChainState::Open;
+                    f_Condition == ConstantCondition::True ? HoistEntry(f_Entry) : WriteEntry(f_Entry, BlockNodeKind::If, f_Condition);
+                    break;
+                }
+
+                f_Parent.m_Chain = f_Condition == ConstantCondition::True ? ChainState::Taken : ChainState::Open;
+                WriteEntry(f_Entry, f_Condition == ConstantCondition::True ? BlockNodeKind::Else : f_Kind, f_Condition);
+                break;
+
+            case BlockNodeKind::Else:
+                if (f_Parent.m_Chain == ChainState::Taken)
+                {
+                    DropSubtree(l_Index);
+                    l_Index += f_Entry.m_SubtreeSize;
+                    continue;
+                }
+
+                if (f_Parent.m_Chain == ChainState::AllFalse)
+                {
+                    f_Parent.m_Chain = ChainState::Taken;
+                    HoistEntry(f_Entry);
+                    break;
+                }
+
+                f_Parent.m_Chain = ChainState::None;
+                WriteEntry(f_Entry, f_Kind, f_Condition);
+                break;
+
+            case BlockNodeKind::WhileLoop:
+                if (f_Condition == ConstantCondition::False)
+                {
+                    DropSubtree(l_Index);
+                    l_Index += f_Entry.m_SubtreeSize;
+                    continue;
+                }
+
+                WriteEntry(f_Entry, f_Kind, f_Condition);
+                break;
+
+            case BlockNodeKind::Break:
+                f_Parent.m_IsUnreachable = true;
+                WriteEntry(f_Entry, f_Kind, f_Condition);
+                break;
+
+            default:
+                WriteEntry(f_Entry, f_Kind, f_Condition);
+                break;
+            }
+
+            l_Index++;
+        }
+
+        while (not pm_OpenLevels.empty())
+        {
+            CloseLevel();
+        }
+
+        //entries moved around, so every subtree size gets recomputed the same way Build() does it
+        std::vector<FlattenedBlockNode>& f_Output = pm_Output.m_Nodes;
+        pm_OpenOutputEntries.clear();
+
+        for (uint32_t l_Entry = 0; l_Entry < f_Output.size(); l_Entry++)
+        {
+            while (not pm_OpenOutputEntries.empty() and f_Output[pm_OpenOutputEntries.back()].m_Depth >= f_Output[l_Entry].m_Depth)
+            {
+                f_Output[pm_OpenOutputEntries.back()].m_SubtreeSize = l_Entry - pm_OpenOutputEntries.back();
+                pm_OpenOutputEntries.pop_back();
+            }
+
+            pm_OpenOutputEntries.push_back(l_Entry);
+        }
+
+        for (const uint32_t l_Entry : pm_OpenOutputEntries)
+        {
+            f_Output[l_Entry].m_SubtreeSize = static_cast<uint32_t>(f_Output.size()) - l_Entry;
+        }
+
+        return pm_Output;
+    }
+
+
+    size_t
+        ScriptOptimizer::GetRemovedNodeCount()
+        const
+    {
+        return pm_RemovedNodeCount;
+    }
+
+
+    void
+        ScriptOptimizer::CloseLevel()
+    {
+        const OpenLevel f_Level = pm_OpenLevels.back();
+        pm_OpenLevels.pop_back();
+
+        OpenLevel* f_Parent = pm_OpenLevels.empty() ? nullptr : &pm_OpenLevels.back();
+
+        if (f_Level.m_IsHoisted) //its children were written into the parent's body, so whatever they did counts for the parent
+        {
+            f_Parent->m_OutputChildCount += f_Level.m_OutputChildCount;
+            f_Parent->m_IsUnreachable = f_Parent->m_IsUnreachable or f_Level.m_IsUnreachable;
+            return;
+        }
+
+        if (f_Level.m_OutputChildCount > 0)
+        {
+            return;
+        }
+
+        const FlattenedBlockNode f_Written = pm_Output.m_Nodes[f_Level.m_OutputEntry];
+
+        if (f_Written.m_Kind == BlockNodeKind::Else and f_Parent and HasPass(ScriptOptimizationPasses::RemoveEmptyElse)) //nothing got written after it, so it's still the last entry
+        {
+            pm_Output.m_Nodes.resize(f_Level.m_OutputEntry);
+            f_Parent->m_OutputChildCount--;
+            pm_RemovedNodeCount++;
+            return;
+        }
+
+        if (f_Level.m_HadChildren and IsBlockOpener(f_Written.m_Kind)) //we emptied it, an empty body wouldn't compile
+        {
+            if (pm_PassOffset == UINT32_MAX)
+            {
+                pm_PassOffset = AppendToPool("pass");
+            }
+
+            FlattenedBlockNode f_Pass = {};
+            f_Pass.m_ID = f_Written.m_ID; //errors on it are still that node's fault
+            f_Pass.m_Kind = BlockNodeKind::Statement;
+            f_Pass.m_Depth = f_Level.m_ChildDepth;
+            f_Pass.m_SubtreeSize = 1;
+            f_Pass.m_SnippetOffset = pm_PassOffset;
+            f_Pass.m_SnippetLength = 4;
+
+            pm_Output.m_Nodes.push_back(f_Pass);
+        }
+    }
+
+
+    void
+        ScriptOptimizer::WriteEntry(const FlattenedBlockNode& fp_Entry, const BlockNodeKind fp_Kind, const ConstantCondition fp_Condition)
+    {
+        OpenLevel& f_Parent = pm_OpenLevels.back();
+
+        FlattenedBlockNode f_Written = fp_Entry;
+        f_Written.m_Kind = fp_Kind;
+        f_Written.m_Depth = f_Parent.m_ChildDepth;
+        f_Written.m_SubtreeSize = 1;
+
+        if (fp_Condition != ConstantCondition::Unknown and fp_Kind != BlockNodeKind::Else and HasPass(ScriptOptimizationPasses::FoldConstantConditions))
+        {
+            uint32_t& f_Offset = fp_Condition == ConstantCondition::True ? pm_TrueOffset : pm_FalseOffset;
+
+            if (f_Offset == UINT32_MAX)
+            {
+                f_Offset = AppendToPool(fp_Condition == ConstantCondition::True ? "True" : "False");
+            }
+
+            f_Written.m_SnippetOffset = f_Offset;
+            f_Written.m_SnippetLength = fp_Condition == ConstantCondition::True ? 4 : 5;
+        }
+
+        f_Parent.m_OutputChildCount++;
+
+        const uint32_t f_OutputEntry = static_cast<uint32_t>(pm_Output.m_Nodes.size());
+        pm_Output.m_Nodes.push_back(f_Written);
+        pm_OpenLevels.push_back({ fp_Entry.m_Depth, f_OutputEntry, f_Written.m_Depth + 1, 0, fp_Entry.m_SubtreeSize > 1 });
+    }
+
+
+    void
+        ScriptOptimizer::HoistEntry(const FlattenedBlockNode& fp_Entry) //the node's own line goes away and its children get written at its depth
+    {
+        const uint32_t f_ChildDepth = pm_OpenLevels.back().m_ChildDepth;
+
+        pm_RemovedNodeCount++;
+        pm_OpenLevels.push_back({ fp_Entry.m_Depth, UINT32_MAX, f_ChildDepth, 0, fp_Entry.m_SubtreeSize > 1, true });
+    }
+
+
+    void
+        ScriptOptimizer::DropSubtree(const uint32_t fp_Index)
+    {
+        pm_RemovedNodeCount += pm_Input->m_Nodes[fp_Index].m_SubtreeSize;
+    }
+
+
+    uint32_t
+        ScriptOptimizer::MergeVariableDefinitions(const uint32_t fp_Index)
+    {
+        const std::vector<FlattenedBlockNode>& f_Nodes = pm_Input->m_Nodes;
+        const FlattenedBlockNode& f_First = f_Nodes[fp_Index];
+
+        if (not IsMergeableDefinition(f_First))
+        {
+            return 0;
+        }
+
+        uint32_t f_RunEnd = fp_Index + 1;
+
+        while (f_RunEnd < f_Nodes.size() and f_RunEnd - fp_Index < MAX_MERGED_DEFINITIONS and f_Nodes[f_RunEnd].m_Depth == f_First.m_Depth and IsMergeableDefinition(f_Nodes[f_RunEnd]))
+        {
+            f_RunEnd++;
+        }
+
+        const uint32_t f_RunLength = f_RunEnd - fp_Index;
+
+        if (f_RunLength < 2)
+        {
+            return 0;
+        }
+
+        pm_MergedDefinitions.clear();
+
+        for (uint32_t l_Index = fp_Index; l_Index < f_RunEnd; l_Index++) //every value is a literal, so a name that gets assigned again later in the run only needs its last value
+        {
+            bool f_IsOverwritten = false;
+
+            for (uint32_t l_Later = l_Index + 1; l_Later < f_RunEnd and not f_IsOverwritten; l_Later++)
+            {
+                f_IsOverwritten = pm_Input->GetName(f_Nodes[l_Later]) == pm_Input->GetName(f_Nodes[l_Index]);
+            }
+
+            if (not f_IsOverwritten)
+            {
+                pm_MergedDefinitions.push_back(l_Index);
+            }
+        }
+
+        OpenLevel& f_Parent = pm_OpenLevels.back();
+
+        FlattenedBlockNode f_Written = f_Nodes[pm_MergedDefinitions.front()];
+        f_Written.m_Depth = f_Parent.m_ChildDepth;
+        f_Written.m_SubtreeSize = 1;
+
+        if (pm_MergedDefinitions.size() > 1)
+        {
+            std::string& f_Pool = pm_Output.m_StringPool;
+
+            f_Written.m_NameOffset = static_cast<uint32_t>(f_Pool.size());
+
+            for (size_t l_Member = 0; l_Member < pm_MergedDefinitions.size(); l_Member++)
+            {
+                f_Pool.append(l_Member == 0 ? "" : ", ").append(pm_Input->GetName(f_Nodes[pm_MergedDefinitions[l_Member]]));
+            }
+
+            f_Written.m_NameLength = static_cast<uint32_t>(f_Pool.size()) - f_Written.m_NameOffset;
+            f_Written.m_SnippetOffset = static_cast<uint32_t>(f_Pool.size());
+
+            for (size_t l_Member = 0; l_Member < pm_MergedDefinitions.size(); l_Member++)
+            {
+                f_Pool.append(l_Member == 0 ? "" : ", ").append(TrimWhitespace(pm_Input->GetCodeSnippet(f_Nodes[pm_MergedDefinitions[l_Member]])));
+            }
+
+            f_Pool += '\n';
+            f_Written.m_SnippetLength = static_cast<uint32_t>(f_Pool.size()) - f_Written.m_SnippetOffset;
+        }
+
+        f_Parent.m_OutputChildCount++;
+        pm_Output.m_Nodes.push_back(f_Written);
+        pm_RemovedNodeCount += f_RunLength - 1;
+
+        return f_RunLength;
+    }
+
+
+    bool
+        ScriptOptimizer::IsMergeableDefinition(const FlattenedBlockNode& fp_Entry)
+        const
+    {
+        if (fp_Entry.m_Kind != BlockNodeKind::VariableDefinition or fp_Entry.m_SubtreeSize != 1)
+        {
+            return false;
+        }
+
+        const std::string_view f_Snippet = pm_Input->GetCodeSnippet(fp_Entry);
+
+        //the Python emitter doesn't end the line itself, so only snippets that end their own line can be rejoined without changing the output around them
+        return IsIdentifier(pm_Input->GetName(fp_Entry)) and not f_Snippet.empty() and f_Snippet.back() == '\n' and IsLiteralExpression(f_Snippet);
+    }
+
+
+    uint32_t
+        ScriptOptimizer::AppendToPool(const std::string_view fp_Text)
+    {
+        const uint32_t f_Offset = static_cast<uint32_t>(pm_Output.m_StringPool.size());
+        pm_Output.m_StringPool += fp_Text;
+        return f_Offset;
+    }
+
+
+    bool
+        ScriptOptimizer::HasPass(const ScriptOptimizationPasses fp_Pass)
+        const
+    {
+        return HasScriptOptimizationPass(pm_Passes, fp_Pass);
+    }
+}